@@ -0,0 +1,193 @@
+// ******************************************************************
+// ----------------- TECHNICAL UNIVERSITY OF KOSICE -----------------
+// ---Department of Electronics and Multimedia Telecommunications ---
+// -------- FACULTY OF ELECTRICAL ENGINEERING AND INFORMATICS -------
+// ------------ THIS CODE IS A PART OF A MASTER'S THESIS ------------
+// ------------------------- Master thesis --------------------------
+// -----------------Patrik Zelenak & Milos Drutarovsky --------------
+// ---------------------------version 0.2.1 -------------------------
+// --------------------------- 19-10-2026 ---------------------------
+// ******************************************************************
+
+/**
+  * This file contains simple benchmark of selected functions,
+  * build it with `make benchmark` and run `./benchmark`.
+  * Time is measured by clock() from standard library, so on MCU
+  * you probably want to replace it with cycle counter (e.g. DWT
+  * on Cortex-M3/M4).
+  *
+  * Every benchmark runs function BENCHMARK_ROUNDS times in chain
+  * (output of one call is input of next call), so compiler can not
+  * optimize calls out.
+**/
+
+#include <time.h>
+#include "ristretto255.h"
+#include "modl.h"
+
+#ifndef BENCHMARK_ROUNDS
+#define BENCHMARK_ROUNDS 2000
+#endif
+
+typedef void (*scalar_fn)(u8 out[BYTES_ELEM_SIZE], const u8 in[BYTES_ELEM_SIZE]);
+
+// returns time of one call in microseconds
+static double benchmark_scalar_fn(scalar_fn fn, u8 state[BYTES_ELEM_SIZE]){
+    u8 tmp[BYTES_ELEM_SIZE];
+    clock_t start;
+    int i, j;
+
+    start = clock();
+    FOR(i, 0, BENCHMARK_ROUNDS){
+      fn(tmp, state);
+      FOR(j, 0, BYTES_ELEM_SIZE){
+        state[j] = tmp[j] ^ 0x57;
+      }
+    }
+    return 1e6 * (double)(clock() - start) / CLOCKS_PER_SEC / BENCHMARK_ROUNDS;
+}
+
+// returns time of one inversion (per element) in batch of 
+// BENCHMARK_BATCH_SIZE scalars in microseconds
+#define BENCHMARK_BATCH_SIZE 64
+static double benchmark_inverse_batch(void){
+    u8 batch_in[BENCHMARK_BATCH_SIZE][BYTES_ELEM_SIZE];
+    u8 batch_out[BENCHMARK_BATCH_SIZE][BYTES_ELEM_SIZE];
+    clock_t start;
+    int i, j, k;
+
+    FOR(i, 0, BENCHMARK_BATCH_SIZE){
+      FOR(j, 0, BYTES_ELEM_SIZE){
+        batch_in[i][j] = (u8)(0xff - i);
+      }
+    }
+    start = clock();
+    FOR(i, 0, BENCHMARK_ROUNDS / BENCHMARK_BATCH_SIZE){
+      modl_l_inverse_batch(batch_out, batch_in, BENCHMARK_BATCH_SIZE);
+      FOR(j, 0, BENCHMARK_BATCH_SIZE){
+        FOR(k, 0, BYTES_ELEM_SIZE){
+          batch_in[j][k] = batch_out[j][k] ^ 0x57;
+        }
+      }
+    }
+    return 1e6 * (double)(clock() - start) / CLOCKS_PER_SEC / (BENCHMARK_ROUNDS / BENCHMARK_BATCH_SIZE * BENCHMARK_BATCH_SIZE);
+}
+
+// Wide reduction (64B -> scalar), mod_l needs input as u32[16],
+// which is also included in measured time (same as at call site)
+typedef void (*wide_fn)(u8 out[BYTES_ELEM_SIZE], const u8 in[HASH_BYTES_SIZE]);
+
+static void wide_mod_l(u8 out[BYTES_ELEM_SIZE], const u8 in[HASH_BYTES_SIZE]){
+    u32 x[16];
+    int i;
+    FOR(i, 0, 16){
+      x[i] = (u32)in[4*i] | (u32)in[4*i+1] << 8 | (u32)in[4*i+2] << 16 | (u32)in[4*i+3] << 24;
+    }
+    mod_l(out, x);
+}
+
+static void wide_from_bytes(u8 out[BYTES_ELEM_SIZE], const u8 in[HASH_BYTES_SIZE]){
+    ristretto255_scalar s;
+    ristretto255_scalar_from_wide_bytes(&s, in);
+    ristretto255_scalar_encode(out, &s);
+}
+
+// returns time of one reduction in microseconds
+static double benchmark_wide_fn(wide_fn fn){
+    u8 state[HASH_BYTES_SIZE];
+    u8 tmp[BYTES_ELEM_SIZE];
+    clock_t start;
+    int i, j;
+
+    FOR(j, 0, HASH_BYTES_SIZE) state[j] = 0xff;
+    start = clock();
+    FOR(i, 0, BENCHMARK_ROUNDS){
+      fn(tmp, state);
+      FOR(j, 0, HASH_BYTES_SIZE){
+        state[j] = tmp[j % BYTES_ELEM_SIZE] ^ (u8)(0x57 + j);
+      }
+    }
+    return 1e6 * (double)(clock() - start) / CLOCKS_PER_SEC / BENCHMARK_ROUNDS;
+}
+
+// returns time of one reduction (per digest) in batch of 
+// BENCHMARK_BATCH_SIZE digests in microseconds
+static double benchmark_wide_batch(void){
+    u8 batch_in[BENCHMARK_BATCH_SIZE][HASH_BYTES_SIZE];
+    ristretto255_scalar batch_out[BENCHMARK_BATCH_SIZE];
+    clock_t start;
+    int i, j, k;
+
+    FOR(i, 0, BENCHMARK_BATCH_SIZE){
+      FOR(j, 0, HASH_BYTES_SIZE){
+        batch_in[i][j] = (u8)(0xff - i);
+      }
+    }
+    start = clock();
+    FOR(i, 0, BENCHMARK_ROUNDS / BENCHMARK_BATCH_SIZE){
+      ristretto255_scalar_from_wide_bytes_batch(batch_out, batch_in, BENCHMARK_BATCH_SIZE);
+      FOR(j, 0, BENCHMARK_BATCH_SIZE){
+        FOR(k, 0, HASH_BYTES_SIZE){
+          batch_in[j][k] ^= (u8)batch_out[j].v[k % 8];
+        }
+      }
+    }
+    return 1e6 * (double)(clock() - start) / CLOCKS_PER_SEC / (BENCHMARK_ROUNDS / BENCHMARK_BATCH_SIZE * BENCHMARK_BATCH_SIZE);
+}
+
+// returns time of one multiplication (mod L) in microseconds,
+// single-lane calls (batch == 0) or multi-lane kernel (batch == 1)
+static double benchmark_scalar_mul(int batch){
+    ristretto255_scalar a[BENCHMARK_BATCH_SIZE], b[BENCHMARK_BATCH_SIZE];
+    clock_t start;
+    int i, j, k;
+
+    FOR(i, 0, BENCHMARK_BATCH_SIZE){
+      FOR(j, 0, 8){
+        a[i].v[j] = 0x01234567u * (i + j + 1);
+        b[i].v[j] = 0x89abcdefu * (i + j + 3);
+      }
+      a[i].v[7] &= 0x0fffffff;
+      b[i].v[7] &= 0x0fffffff;
+    }
+    start = clock();
+    FOR(i, 0, BENCHMARK_ROUNDS / BENCHMARK_BATCH_SIZE){
+      if (batch){
+        ristretto255_scalar_mul_batch(a, a, b, BENCHMARK_BATCH_SIZE);
+      }
+      else{
+        FOR(k, 0, BENCHMARK_BATCH_SIZE){
+          ristretto255_scalar_mul(&a[k], &a[k], &b[k]);
+        }
+      }
+    }
+    return 1e6 * (double)(clock() - start) / CLOCKS_PER_SEC / (BENCHMARK_ROUNDS / BENCHMARK_BATCH_SIZE * BENCHMARK_BATCH_SIZE);
+}
+
+int main(){
+    u8 state[BYTES_ELEM_SIZE];
+    int i;
+
+    printf("----- modular inverse (mod L), %d rounds -----\n", BENCHMARK_ROUNDS);
+
+    FOR(i, 0, BYTES_ELEM_SIZE) state[i] = 0xff;
+    printf("%-38s %8.2f us\n", "inverse_mod_l (Barrett):", benchmark_scalar_fn(inverse_mod_l, state));
+
+    FOR(i, 0, BYTES_ELEM_SIZE) state[i] = 0xff;
+    printf("%-38s %8.2f us\n", "crypto_x25519_inverse (Montgomery):", benchmark_scalar_fn(crypto_x25519_inverse, state));
+
+    FOR(i, 0, BYTES_ELEM_SIZE) state[i] = 0xff;
+    printf("%-38s %8.2f us\n", "inverse_mod_l_chain (addition chain):", benchmark_scalar_fn(inverse_mod_l_chain, state));
+    printf("%-38s %8.2f us\n", "modl_l_inverse_batch (per scalar):", benchmark_inverse_batch());
+
+    printf("----- wide reduction (64B -> mod L), %d rounds -----\n", BENCHMARK_ROUNDS);
+    printf("%-38s %8.2f us\n", "mod_l (Barrett):", benchmark_wide_fn(wide_mod_l));
+    printf("%-38s %8.2f us\n", "from_wide_bytes (sparse L):", benchmark_wide_fn(wide_from_bytes));
+    printf("%-38s %8.2f us\n", "from_wide_bytes_batch (per hash):", benchmark_wide_batch());
+
+    printf("----- scalar multiplication (mod L), %d lanes -----\n", RISTRETTO255_SCALAR_LANES);
+    printf("%-38s %8.2f us\n", "ristretto255_scalar_mul:", benchmark_scalar_mul(0));
+    printf("%-38s %8.2f us\n", "ristretto255_scalar_mul_batch:", benchmark_scalar_mul(1));
+
+    return 0;
+}
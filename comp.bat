@@ -1,3 +1,3 @@
-gcc -Os -Wall -Wno-unused-function -Werror -Wextra -o main main.c gf25519.c utils.c modl.c ristretto255.c && main.exe
+gcc -Os -Wall -Wno-unused-function -Werror -Wextra -o main main.c gf25519.c utils.c modl.c ristretto255.c ristretto255_cache.c ristretto255_table_file.c ristretto255_pool.c sha512.c && main.exe
 
 rem NOTE: You can set various flags in config.h
\ No newline at end of file
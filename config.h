@@ -102,6 +102,81 @@
 	* or comment, if you want to use Barrett’s reduction.
 **/
 //#define MONTGOMERY_MODL_INVERSE_FLAG
+/** *****************************************************************
+	* Third option is inverse_mod_l_chain, which uses Montgomery’s
+	* reduction, dedicated squaring and fixed addition chain for L-2
+	* (252 squarings + 35 multiplications instead of 253 + 125).
+	* You can compare all three options with `make benchmark`.
+	*
+	* Comment this flag if you want to use one of options above
+	* (this flag has priority over MONTGOMERY_MODL_INVERSE_FLAG).
+**/
+#define CHAIN_MODL_INVERSE_FLAG
+/** *****************************************************************
+	* Arithmetic modulo L (modl.c) works by default with 8x 32-bit
+	* words and 64-bit products, which suits 32-bit MCUs.
+	* On 64-bit hosts you can uncomment MODL_64BIT_FLAG, so mod_l,
+	* redc and multiplications work with 4x 64-bit limbs and
+	* 128-bit products (compiler has to support unsigned __int128).
+	* Results are identical for both options.
+**/
+//#define MODL_64BIT_FLAG
+
+
+
+
+/** *****************************************************************
+	* LOW_STACK_FLAG selects low-stack profile for MCUs with small
+	* (RTOS thread) stacks. It trades speed for stack:
+	* SHA-512 computes message schedule in 16 words instead of 80,
+	* fixed-window batch scalar multiplications (and cache) use ladder
+	* instead of window table of 8 points (1KB), multi-lane scalar
+	* kernels use only 1 lane. Results are identical.
+	*
+	* RISTRETTO255_STACK_BUDGET is peak stack (in bytes) which no
+	* public function may exceed in this profile, it is checked by
+	* `make stack_report` (see stack_report.c).
+	*
+	* Uncomment if you want to use low-stack profile.
+**/
+//#define LOW_STACK_FLAG
+
+#ifdef LOW_STACK_FLAG
+#ifndef RISTRETTO255_STACK_BUDGET
+#define RISTRETTO255_STACK_BUDGET 2048
+#endif
+#endif
+
+
+
+
+/** *****************************************************************
+	* TABLE_FILE_MMAP_FLAG enables ristretto255_table_file_map (mmap
+	* of precomputed table file, see ristretto255_table_file.h),
+	* which needs POSIX. By default it is set only on POSIX systems,
+	* without it table file can still be used from memory/flash by
+	* ristretto255_table_file_parse.
+	*
+	* Comment this block if you do not want mmap loader at all.
+**/
+#if defined(__unix__) || defined(__APPLE__)
+#define TABLE_FILE_MMAP_FLAG
+#endif
+
+
+
+
+/** *****************************************************************
+	* THREAD_POOL_FLAG enables worker threads (POSIX threads) of
+	* ristretto255_pool (see ristretto255_pool.h). By default it is
+	* set only on POSIX systems, without it batch functions of pool
+	* run sequentially in calling thread.
+	*
+	* Comment this block if you do not want threads at all.
+**/
+#if defined(__unix__) || defined(__APPLE__)
+#define THREAD_POOL_FLAG
+#endif
 
 
 #endif // _CONFIG_H
@@ -53,6 +53,12 @@
 #define BYTES_ELEM_SIZE 32 
 #define HASH_BYTES_SIZE 2*BYTES_ELEM_SIZE 
 
+// The macro AFFINE_BYTES_SIZE defines the size of uncompressed
+// affine (x, y) export of ristretto255_point (u8x64), which is
+// meant only for transfer between trusted parties, see 
+// ristretto255_export_affine().
+#define AFFINE_BYTES_SIZE 2*BYTES_ELEM_SIZE
+
 typedef uint8_t  u8;
 typedef uint32_t u32;
 typedef uint64_t u64;
@@ -65,6 +71,114 @@ typedef struct ge_point25519 {
     field_elem x,y,z,t;
 } ristretto255_point;
 
+// affine-Niels repr. of point with Z = 1, (Y+X, Y-X, 2*D*T),
+// which is used as second operand in mixed addition
+// (see ristretto255_point_addition_niels)
+typedef struct ristretto255_niels_point {
+    field_elem ypx,ymx,xy2d;
+} ristretto255_niels_point;
+
+// cached repr. of projective point (Y+X, Y-X, Z, 2*D*T),
+// used in precomputed tables of windowed scalar multiplication
+typedef struct ristretto255_cached_point {
+    field_elem ypx,ymx,z,t2d;
+} ristretto255_cached_point;
+
+// handle of ristretto255_point with memoized encoding, 
+// see ristretto255_handle_* functions in ristretto255.c
+typedef struct ristretto255_handle {
+    ristretto255_point point;
+    u8 encoding[BYTES_ELEM_SIZE];
+    // 1 if encoding is already computed
+    int has_encoding;
+    // 1 if point comes from successful ristretto255_decode
+    int is_validated;
+} ristretto255_handle;
+
+// Number of points (lanes) in one block of ristretto255_point_batch
+#define RISTRETTO255_BATCH_LANES 8
+// Number of blocks of ristretto255_point_batch for len points
+#define RISTRETTO255_BATCH_BLOCKS(len) (((len) + RISTRETTO255_BATCH_LANES - 1) / RISTRETTO255_BATCH_LANES)
+
+// structure-of-arrays block of RISTRETTO255_BATCH_LANES points, limb
+// i of coord X of point in lane j is stored in x[i][j], so the same
+// limb of all lanes is contiguous (one 32B row) and every coord
+// starts at cache-line boundary, which is layout suitable for vector
+// kernels. Any number of points is stored in array of blocks, point
+// n is in lane n % RISTRETTO255_BATCH_LANES of block
+// n / RISTRETTO255_BATCH_LANES. Library has no SIMD kernels (field
+// arithmetic is per point), so it only converts between this layout
+// and ristretto255_point (ristretto255_point_batch_load/store in
+// ristretto255.c), batch stages take arrays of ristretto255_point.
+typedef struct ristretto255_point_batch {
+    _Alignas(64) u32 x[FIELED_ELEM_SIZE][RISTRETTO255_BATCH_LANES];
+    _Alignas(64) u32 y[FIELED_ELEM_SIZE][RISTRETTO255_BATCH_LANES];
+    _Alignas(64) u32 z[FIELED_ELEM_SIZE][RISTRETTO255_BATCH_LANES];
+    _Alignas(64) u32 t[FIELED_ELEM_SIZE][RISTRETTO255_BATCH_LANES];
+} ristretto255_point_batch;
+
+// Number of signed radix-16 digits of 256-bit scalar, 
+// (64 nibbles + 1 carry digit, see scalar_recode_radix16)
+#define SCALAR_DIGITS 65
+// Number of precomputed multiples P, 2P, ..., 8P in window table
+#define WINDOW_TABLE_SIZE 8
+
+// precomputed window table of point P (P, 2P, ..., 8P), which can
+// be reused for many scalar multiplications of the same point, see
+// ristretto255_table_build/ristretto255_scalarmult_table
+typedef struct ristretto255_table {
+    ristretto255_cached_point entry[WINDOW_TABLE_SIZE];
+} ristretto255_table;
+
+// state of resumable scalar multiplication, see
+// ristretto255_scalarmult_init/step/finish in ristretto255.c
+typedef struct ristretto255_scalarmult_ctx {
+    ristretto255_point acc;
+    ristretto255_cached_point table[WINDOW_TABLE_SIZE];
+    signed char digits[SCALAR_DIGITS];
+    int digits_len;
+    int next_digit;
+} ristretto255_scalarmult_ctx;
+
+// Number of field_elem slots of ristretto255_ws, the deepest
+// use is hash_to_group (2 halves + MAP 5 + inv_sqrt 2) and 
+// ristretto255_encode (7 + inv_sqrt 2)
+#define RISTRETTO255_WS_SLOTS 9
+
+// caller-owned workspace of ristretto255_*_ws functions, they
+// use slots fe (and pt) instead of their own temporaries and do
+// not wipe them, caller wipes whole workspace once by
+// ristretto255_ws_wipe (see ristretto255.c). Note that sizeof is
+// 576B (not 544B), since _Alignas(64) pads it to whole cache lines
+typedef struct ristretto255_ws {
+    _Alignas(64) field_elem fe[RISTRETTO255_WS_SLOTS];
+    ristretto255_point pt[2];
+} ristretto255_ws;
+
+// scalar modulo L (group order) as 8x u32 words, least significant
+// word first, always fully reduced (< L), see ristretto255_scalar_*
+// functions in modl.c
+typedef struct ristretto255_scalar {
+    u32 v[8];
+} ristretto255_scalar;
+
+// scalar in Montgomery form (a * 2^256 mod L), chain of
+// multiplications can stay in this form and convert only
+// at the boundaries (ristretto255_scalar_to_mont/from_mont)
+typedef struct ristretto255_scalar_mont {
+    u32 v[8];
+} ristretto255_scalar_mont;
+
+// caller-owned workspace of Montgomery multiplication (product and
+// temporaries of reduction), ristretto255_scalar_*_ws functions do
+// not wipe it, caller wipes it once after whole chain by
+// ristretto255_mont_ws_wipe (see modl.c)
+typedef struct ristretto255_mont_ws {
+    u32 product[16];
+    u32 s[8];
+    u32 t[16];
+} ristretto255_mont_ws;
+
 
 // Here we implemented some macros to make
 // code more readable. 
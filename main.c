@@ -25,7 +25,11 @@
 **/
 
 
+#include <string.h>
 #include "ristretto255.h"
+#include "ristretto255_cache.h"
+#include "ristretto255_table_file.h"
+#include "ristretto255_pool.h"
 #include "gf25519.h"
 #include "modl.h"
 #include "test_config.h"
@@ -33,6 +37,44 @@
 #define pack25519 pack
 #define unpack25519 unpack
 
+// job of THREAD_POOL test, workers share one small cache, item i
+// decodes (or multiplies) encoding i%16 through cache
+typedef struct cache_pool_job {
+    ristretto255_cache* cache;
+    const u8 (*encodings)[BYTES_ELEM_SIZE];
+    const ristretto255_point* points;
+    const ristretto255_point* products;
+    const u8* scalar;
+} cache_pool_job;
+
+// key of cache entry or table slot is stored in atomic words
+static void cache_key_bytes(u8 out[BYTES_ELEM_SIZE], const atomic_uint key[]){
+    u32 w;
+    for (size_t i = 0; i < RISTRETTO255_CACHE_WORDS(u8[BYTES_ELEM_SIZE]); ++i){
+        w = atomic_load(&key[i]);
+        memcpy(out + i*sizeof(u32), &w, sizeof(u32));
+    }
+}
+
+static int cache_pool_task(void* job, size_t start, size_t end){
+    cache_pool_job* cache_job = (cache_pool_job*)job;
+    ristretto255_point p;
+    size_t i;
+    int failed = 0;
+
+    for (i = start; i < end; ++i){
+        if ((i / 16) % 2 == 0){
+            failed |= ristretto255_cache_decode(cache_job->cache, &p, cache_job->encodings[i%16]) != 0;
+            failed |= !ristretto255_point_eq(&p, &cache_job->points[i%16]);
+        }
+        else{
+            failed |= ristretto255_cache_scalarmult(cache_job->cache, &p, cache_job->encodings[i%16], cache_job->scalar) != 0;
+            failed |= !ristretto255_point_eq(&p, &cache_job->products[i%16]);
+        }
+    }
+    return failed;
+}
+
 int main(){
     
 
@@ -117,6 +159,37 @@ int main(){
         {0x80, 0xbd, 0x7, 0x26, 0x25, 0x11, 0xcd, 0xde, 0x48, 0x63, 0xf8, 0xa7, 0x43, 0x4c, 0xef, 0x69, 0x67, 0x50, 0x68, 0x1c, 0xb9, 0x51, 0xe, 0xea, 0x55, 0x70, 0x88, 0xf7, 0x6d, 0x9e, 0x50, 0x65}
     };
 
+    // FIPS 180-4 examples, SHA-512("abc") and SHA-512 of 112B
+    // (two-block) message "abcdefghbcdefghi...nopqrstu"
+    u8 SHA512_VECTORS_RESULT[2][HASH_BYTES_SIZE] = {
+        {0xdd, 0xaf, 0x35, 0xa1, 0x93, 0x61, 0x7a, 0xba, 0xcc, 0x41, 0x73, 0x49, 0xae, 0x20, 0x41, 0x31, 0x12, 0xe6, 0xfa, 0x4e, 0x89, 0xa9, 0x7e, 0xa2, 0x0a, 0x9e, 0xee, 0xe6, 0x4b, 0x55, 0xd3, 0x9a, 0x21, 0x92, 0x99, 0x2a, 0x27, 0x4f, 0xc1, 0xa8, 0x36, 0xba, 0x3c, 0x23, 0xa3, 0xfe, 0xeb, 0xbd, 0x45, 0x4d, 0x44, 0x23, 0x64, 0x3c, 0xe8, 0x0e, 0x2a, 0x9a, 0xc9, 0x4f, 0xa5, 0x4c, 0xa4, 0x9f},
+        {0x8e, 0x95, 0x9b, 0x75, 0xda, 0xe3, 0x13, 0xda, 0x8c, 0xf4, 0xf7, 0x28, 0x14, 0xfc, 0x14, 0x3f, 0x8f, 0x77, 0x79, 0xc6, 0xeb, 0x9f, 0x7f, 0xa1, 0x72, 0x99, 0xae, 0xad, 0xb6, 0x88, 0x90, 0x18, 0x50, 0x1d, 0x28, 0x9e, 0x49, 0x00, 0xf7, 0xe4, 0x33, 0x1b, 0x99, 0xde, 0xc4, 0xb5, 0x43, 0x3a, 0xc7, 0xd3, 0x29, 0xee, 0xb6, 0xdd, 0x26, 0x54, 0x5e, 0x96, 0xe5, 0x5b, 0x87, 0x4b, 0xe9, 0x09}
+    };
+
+    // expand_message_xmd(SHA-512) with DST "QUUX-V01-CS02-with-expander-SHA512-256"
+    // of msg "abc" (64B) and "abcdef0123456789" (128B)
+    u8 XMD_VECTORS_RESULT[2][2*HASH_BYTES_SIZE] = {
+        {0x4a, 0x05, 0xd1, 0xb4, 0x9d, 0x71, 0x53, 0xfb, 0x51, 0x2d, 0xf8, 0x3b, 0x85, 0x64, 0xfe, 0x17, 0x54, 0xc6, 0x07, 0xe2, 0xfb, 0xbc, 0x3d, 0x97, 0xc5, 0x91, 0xfa, 0x17, 0x5b, 0x6f, 0xca, 0x1e, 0xfb, 0x30, 0x04, 0x62, 0xd9, 0x6e, 0xd6, 0x13, 0xf1, 0x53, 0x4e, 0xcb, 0x26, 0x06, 0x71, 0xeb, 0x84, 0x69, 0xa2, 0x00, 0x71, 0x04, 0x9d, 0xc8, 0x02, 0x1b, 0x98, 0x68, 0x28, 0x54, 0x05, 0x92},
+        {0x3f, 0x72, 0x1f, 0x20, 0x8e, 0x61, 0x99, 0xfe, 0x90, 0x35, 0x45, 0xab, 0xc2, 0x6c, 0x83, 0x7c, 0xe5, 0x9a, 0xc6, 0xfa, 0x45, 0x73, 0x3f, 0x1b, 0xaa, 0xf0, 0x22, 0x2f, 0x8b, 0x7a, 0xcb, 0x04, 0x24, 0x81, 0x4f, 0xcb, 0x5e, 0xec, 0xf6, 0xc1, 0xd3, 0x8f, 0x06, 0xe9, 0xd0, 0xa6, 0xcc, 0xfb, 0xf8, 0x5a, 0xe6, 0x12, 0xab, 0x87, 0x35, 0xdf, 0xdf, 0x9c, 0xe8, 0x4c, 0x37, 0x2a, 0x77, 0xc8, 0xf9, 0xe1, 0xc1, 0xe9, 0x52, 0xc3, 0xa6, 0x1b, 0x75, 0x67, 0xdd, 0x06, 0x93, 0x01, 0x6a, 0xf5, 0x1d, 0x27, 0x45, 0x82, 0x26, 0x63, 0xd0, 0xc2, 0x36, 0x7e, 0x3f, 0x4f, 0x0b, 0xed, 0x82, 0x7f, 0xee, 0xcc, 0x2a, 0xaf, 0x98, 0xc9, 0x49, 0xb5, 0xed, 0x0d, 0x35, 0xc3, 0xf1, 0x02, 0x3d, 0x64, 0xad, 0x14, 0x07, 0x92, 0x42, 0x88, 0xd3, 0x66, 0xea, 0x15, 0x9f, 0x46, 0x28, 0x7e, 0x61, 0xac}
+    };
+
+    // expand_message_xmd(SHA-512) of msg "abc" (64B) with oversized
+    // DST of 300x 'a' 
+    u8 XMD_OVERSIZE_DST_RESULT[HASH_BYTES_SIZE] = {
+        0x8a, 0x74, 0x89, 0x0b, 0x31, 0xa2, 0x1f, 0x07, 0xd0, 0x37, 0x34, 0x6d, 0x9b, 0xbf, 0x45, 0x9e, 0x5a, 0x3f, 0x9e, 0x62, 0xf6, 0xcc, 0xa9, 0xf2, 0x7c, 0x25, 0x0c, 0xe1, 0xe2, 0xf9, 0x6a, 0x20, 0xb3, 0x8f, 0xb0, 0x42, 0x62, 0x2a, 0x9a, 0xd2, 0x9d, 0xe3, 0xf5, 0x8d, 0x25, 0x6c, 0x57, 0xf3, 0x6b, 0x9b, 0xf7, 0xc3, 0xfc, 0xea, 0x32, 0x34, 0x0f, 0x65, 0x0a, 0x7f, 0xc9, 0x87, 0x74, 0xc5
+    };
+
+    // scalar arithmetic vectors: a, b, a+b, a-b, a*b (mod L) 
+    // and L-1 (largest canonical scalar)
+    u8 SCALAR_VECTORS[6][BYTES_ELEM_SIZE] = {
+        {0x21, 0x4c, 0x85, 0x4c, 0x2e, 0xdf, 0xc6, 0x4e, 0x27, 0xf8, 0xec, 0xa8, 0x5b, 0x64, 0x63, 0x0e, 0xfb, 0x6f, 0x74, 0x53, 0x8b, 0x54, 0xca, 0x4e, 0x83, 0x10, 0xe6, 0x20, 0xd5, 0x52, 0x12, 0x03},
+        {0xb3, 0x5a, 0x46, 0x59, 0xaf, 0x59, 0x86, 0x7d, 0x3f, 0xee, 0x41, 0x8e, 0xa8, 0xf6, 0xea, 0x42, 0x32, 0xa2, 0xef, 0xfc, 0xcd, 0xd2, 0x51, 0x1c, 0xaf, 0x27, 0x1a, 0xb1, 0x49, 0x40, 0x96, 0x0f},
+        {0xe7, 0xd2, 0xd5, 0x48, 0xc3, 0xd5, 0x3a, 0x74, 0x90, 0x49, 0x37, 0x94, 0x25, 0x61, 0x6f, 0x3c, 0x2d, 0x12, 0x64, 0x50, 0x59, 0x27, 0x1c, 0x6b, 0x32, 0x38, 0x00, 0xd2, 0x1e, 0x93, 0xa8, 0x02},
+        {0x5b, 0xc5, 0x34, 0x50, 0x99, 0xe8, 0x52, 0x29, 0xbe, 0xa6, 0xa2, 0xbd, 0x91, 0x67, 0x57, 0xe0, 0xc8, 0xcd, 0x84, 0x56, 0xbd, 0x81, 0x78, 0x32, 0xd4, 0xe8, 0xcb, 0x6f, 0x8b, 0x12, 0x7c, 0x03},
+        {0xdc, 0xf4, 0x6c, 0xf8, 0x29, 0x68, 0x4e, 0x9c, 0xf9, 0x29, 0xd3, 0x7e, 0x8a, 0xe9, 0x1c, 0x93, 0x3f, 0xb9, 0x10, 0x25, 0x51, 0x9e, 0xfc, 0x88, 0x75, 0xb1, 0x49, 0xe8, 0xc4, 0xb6, 0x36, 0x0f},
+        {0xec, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10}
+    };
+
     u8 RISTRETTO255_BASEPOINT[BYTES_ELEM_SIZE] = {
         0xe2, 0xf2, 0xae, 0xa, 
         0x6a, 0xbc, 0x4e, 0x71, 
@@ -161,6 +234,16 @@ int main(){
 
 
 
+    // scalars used in tests of windowed scalar multiplication,
+    // compared against ristretto255_scalarmult
+    u8 TEST_SCALARS[3][BYTES_ELEM_SIZE] = {
+        {0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff,0xff},
+        {0x9,0x78,0xd0,0xfb,0xe4,0x4d,0x7c,0x69,0x60,0xa9,0xab,0x59,0xf3,0xad,0x3c,0x13,0xd8,0x9b,0xd1,0xe6,0x11,0x2a,0x65,0xeb,0x48,0xc9,0x9d,0x7a,0x18,0x40,0x88,0x5f},
+        {0x88,0x87,0x78,0x08,0x80,0x77,0x00,0x8f,0xf8,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00}
+    };
+
+
+
     ///////////////////////////////////////////////////
     //
     //       tttttttt   eeeeeee     ssssss   tttttttt
@@ -176,6 +259,7 @@ int main(){
     int subresult = 1;
     //temporary variables
     u8 bytes_out_[BYTES_ELEM_SIZE] = {0};
+    u8 bytes_out_64[AFFINE_BYTES_SIZE] = {0};
     field_elem in;
     ristretto255_point output_ristretto_point;
     ristretto255_point *out_rist = &output_ristretto_point;
@@ -205,6 +289,640 @@ int main(){
     }
     
 
+    // testing batch normalization (Z = 1) and affine-Niels conversion
+    // of small multiples of generator, projective results of
+    // ristretto255_scalarmult are used as input
+    ristretto255_point multiples[16];
+    ristretto255_niels_point multiples_niels[16];
+    for (int i = 0; i < 16; ++i)
+    {
+        INTG[0] = i;
+        ristretto255_decode(out_rist,RISTRETTO255_BASEPOINT);
+        ristretto255_scalarmult(&multiples[i], out_rist,INTG);
+    }
+    ristretto255_batch_to_niels(multiples_niels, multiples, 16);
+    ristretto255_batch_normalize(multiples, multiples, 16);
+
+    for (int i = 0; i < 16; ++i)
+    {
+        ristretto255_encode(bytes_out_,&multiples[i]);
+        subresult = bytes_eq_32(bytes_out_, SMALL_MULTIPLES_OF_GENERATOR_VECTORS[i]);
+        subresult &= multiples[i].z[0] == 1;
+        for (int j = 1; j < FIELED_ELEM_SIZE; ++j){
+            subresult &= multiples[i].z[j] == 0;
+        }
+
+        // identity + niels(i*B)
+        ristretto255_decode(out_rist,SMALL_MULTIPLES_OF_GENERATOR_VECTORS[0]);
+        ristretto255_point_addition_niels(out_rist2, out_rist, &multiples_niels[i]);
+        ristretto255_encode(bytes_out_,out_rist2);
+        subresult &= bytes_eq_32(bytes_out_, SMALL_MULTIPLES_OF_GENERATOR_VECTORS[i]);
+        result &= subresult;
+
+        #ifdef VERBOSE_FLAG
+        if (!subresult){
+                printf("BATCH_NORMALIZE TEST no.%d: FAILED! Error was found when comparing result to SMALL_MULTIPLES_OF_GENERATOR_VECTORS[%d]\n",i,i);
+        }
+        else{
+            printf("BATCH_NORMALIZE TEST no.%d: SUCCESS!\n",i);
+        }
+        #endif  
+    }
+
+
+    // testing point equality and identity without encoding,
+    // normalized multiples are compared with projective ones
+    for (int i = 0; i < 16; ++i)
+    {
+        INTG[0] = i;
+        ristretto255_decode(out_rist,RISTRETTO255_BASEPOINT);
+        ristretto255_scalarmult(out_rist2, out_rist,INTG);
+
+        subresult = ristretto255_point_eq(out_rist2, &multiples[i]);
+        subresult &= !ristretto255_point_eq(out_rist2, &multiples[(i+1)%16]);
+        subresult &= ristretto255_is_identity(out_rist2) == (i == 0);
+        result &= subresult;
+
+        #ifdef VERBOSE_FLAG
+        if (!subresult){
+                printf("POINT_EQ TEST no.%d: FAILED! Error was found when comparing %d*B with normalized multiples\n",i,i);
+        }
+        else{
+            printf("POINT_EQ TEST no.%d: SUCCESS!\n",i);
+        }
+        #endif  
+    }
+
+
+    // testing sum of points, 0*B + 1*B + ... + 15*B = 120*B
+    INTG[0] = 120;
+    ristretto255_decode(out_rist,RISTRETTO255_BASEPOINT);
+    ristretto255_scalarmult(out_rist2, out_rist,INTG);
+    ristretto255_point_sum(out_rist, multiples, 16);
+    subresult = ristretto255_point_eq(out_rist, out_rist2);
+    ristretto255_point_sum_niels(out_rist, multiples_niels, 16);
+    subresult &= ristretto255_point_eq(out_rist, out_rist2);
+    ristretto255_point_sum(out_rist, multiples, 0);
+    subresult &= ristretto255_is_identity(out_rist);
+    result &= subresult;
+
+    #ifdef VERBOSE_FLAG
+    if (!subresult){
+            printf("POINT_SUM TEST: FAILED! Error was found when comparing sum of multiples with 120*B\n");
+    }
+    else{
+        printf("POINT_SUM TEST: SUCCESS!\n");
+    }
+    #endif  
+
+
+    // testing trusted affine export/import, projective multiples
+    // are exported in batch, imported and compared, tampered
+    // and non-canonical inputs should result in error
+    u8 affine_bytes[16][AFFINE_BYTES_SIZE];
+    ristretto255_point projective_multiples[16];
+    for (int i = 0; i < 16; ++i)
+    {
+        INTG[0] = i;
+        ristretto255_decode(out_rist,RISTRETTO255_BASEPOINT);
+        ristretto255_scalarmult(&projective_multiples[i], out_rist,INTG);
+    }
+    ristretto255_export_affine_batch(affine_bytes, projective_multiples, 16);
+    for (int i = 0; i < 16; ++i)
+    {
+        subresult = ristretto255_import_affine(out_rist, affine_bytes[i]) == 0;
+        subresult &= ristretto255_point_eq(out_rist, &multiples[i]);
+        ristretto255_export_affine(bytes_out_64, &projective_multiples[i]);
+        subresult &= ristretto255_import_affine(out_rist2, bytes_out_64) == 0;
+        subresult &= ristretto255_point_eq(out_rist2, &multiples[i]);
+
+        bytes_out_64[i] ^= 0x01;
+        subresult &= ristretto255_import_affine(out_rist2, bytes_out_64) == 1;
+        result &= subresult;
+
+        #ifdef VERBOSE_FLAG
+        if (!subresult){
+                printf("AFFINE_EXPORT TEST no.%d: FAILED! Error was found when testing affine export of %d*B\n",i,i);
+        }
+        else{
+            printf("AFFINE_EXPORT TEST no.%d: SUCCESS!\n",i);
+        }
+        #endif  
+    }
+    // x = 2^255-19 + 0 is non-canonical representation of x = 0
+    for (int j = 0; j < BYTES_ELEM_SIZE; ++j){
+        bytes_out_64[j] = non_canonical_vectors[3][j];
+        bytes_out_64[j+BYTES_ELEM_SIZE] = j == 0;
+    }
+    subresult = ristretto255_import_affine(out_rist2, bytes_out_64) == 1;
+    bytes_out_64[0] = 0;
+    for (int j = 1; j < BYTES_ELEM_SIZE; ++j){
+        bytes_out_64[j] = 0;
+    }
+    subresult &= ristretto255_import_affine(out_rist2, bytes_out_64) == 0;
+    subresult &= ristretto255_is_identity(out_rist2);
+    result &= subresult;
+
+    #ifdef VERBOSE_FLAG
+    if (!subresult){
+            printf("AFFINE_IMPORT non-canonical TEST: FAILED!\n");
+    }
+    else{
+        printf("AFFINE_IMPORT non-canonical TEST: SUCCESS!\n");
+    }
+    #endif  
+
+
+    // testing fixed scalar, many points scalar multiplication
+    ristretto255_point many_out[16];
+    for (int k = 0; k < 3; ++k)
+    {
+        ristretto255_scalarmult_many(many_out, multiples, TEST_SCALARS[k], 16);
+        subresult = 1;
+        for (int i = 0; i < 16; ++i)
+        {
+            output_ristretto_point = multiples[i];
+            ristretto255_scalarmult(out_rist2, out_rist, TEST_SCALARS[k]);
+            subresult &= ristretto255_point_eq(out_rist2, &many_out[i]);
+        }
+        result &= subresult;
+
+        #ifdef VERBOSE_FLAG
+        if (!subresult){
+                printf("SCALARMULT_MANY TEST no.%d: FAILED! Error was found when comparing result with ristretto255_scalarmult for TEST_SCALARS[%d]\n",k,k);
+        }
+        else{
+            printf("SCALARMULT_MANY TEST no.%d: SUCCESS!\n",k);
+        }
+        #endif  
+    }
+
+
+    // testing independent batch scalar multiplication with full-width
+    // scalars, every point is multiplied by different scalar
+    u8 batch_scalars[16][BYTES_ELEM_SIZE];
+    for (int i = 0; i < 16; ++i)
+    {
+        for (int j = 0; j < BYTES_ELEM_SIZE; ++j){
+            batch_scalars[i][j] = TEST_SCALARS[i%3][j] ^ (u8)(i*j);
+        }
+    }
+    ristretto255_scalarmult_batch_bits(many_out, multiples, batch_scalars, 16, 256);
+    for (int i = 0; i < 16; ++i)
+    {
+        output_ristretto_point = multiples[i];
+        ristretto255_scalarmult(out_rist2, out_rist, batch_scalars[i]);
+        subresult = ristretto255_point_eq(out_rist2, &many_out[i]);
+        result &= subresult;
+
+        #ifdef VERBOSE_FLAG
+        if (!subresult){
+                printf("SCALARMULT_BATCH_BITS(256) TEST no.%d: FAILED! Error was found when comparing result with ristretto255_scalarmult\n",i);
+        }
+        else{
+            printf("SCALARMULT_BATCH_BITS(256) TEST no.%d: SUCCESS!\n",i);
+        }
+        #endif  
+    }
+
+
+    // testing short scalar multiplication, result is compared with
+    // ristretto255_scalarmult of scalar masked to "bits" bits
+    int short_bits[6] = {1, 7, 64, 128, 255, 256};
+    u8 masked_scalar[BYTES_ELEM_SIZE];
+    for (int k = 0; k < 6; ++k)
+    {
+        for (int j = 0; j < BYTES_ELEM_SIZE; ++j){
+            int bits_left = short_bits[k] - 8*j;
+            masked_scalar[j] = bits_left >= 8 ? TEST_SCALARS[0][j] : bits_left <= 0 ? 0 : TEST_SCALARS[0][j] & ((1 << bits_left) - 1);
+        }
+        output_ristretto_point = multiples[k+1];
+        ristretto255_scalarmult(out_rist2, out_rist, masked_scalar);
+        ristretto255_scalarmult_bits(&many_out[0], &multiples[k+1], TEST_SCALARS[0], short_bits[k]);
+        ristretto255_scalarmult_batch_bits(&many_out[1], &multiples[k+1], &masked_scalar, 1, short_bits[k]);
+        subresult = ristretto255_point_eq(out_rist2, &many_out[0]);
+        subresult &= ristretto255_point_eq(out_rist2, &many_out[1]);
+        result &= subresult;
+
+        #ifdef VERBOSE_FLAG
+        if (!subresult){
+                printf("SCALARMULT_BITS TEST no.%d: FAILED! Error was found when testing %d-bit scalar\n",k,short_bits[k]);
+        }
+        else{
+            printf("SCALARMULT_BITS TEST no.%d: SUCCESS!\n",k);
+        }
+        #endif  
+    }
+
+
+    // testing resumable scalar multiplication, steps of various
+    // size are compared with ristretto255_scalarmult
+    ristretto255_scalarmult_ctx sm_ctx;
+    int step_sizes[4] = {1, 7, 64, 100};
+    for (int k = 0; k < 4; ++k)
+    {
+        int steps = 0;
+        ristretto255_scalarmult_init(&sm_ctx, &multiples[k+1], TEST_SCALARS[k%3]);
+        subresult = ristretto255_scalarmult_finish(&sm_ctx, out_rist2) == 1;
+
+        ristretto255_scalarmult_init(&sm_ctx, &multiples[k+1], TEST_SCALARS[k%3]);
+        while (ristretto255_scalarmult_step(&sm_ctx, step_sizes[k])){
+            steps++;
+        }
+        subresult &= steps == (SCALAR_DIGITS-1)/step_sizes[k];
+        subresult &= ristretto255_scalarmult_finish(&sm_ctx, &many_out[0]) == 0;
+
+        output_ristretto_point = multiples[k+1];
+        ristretto255_scalarmult(out_rist2, out_rist, TEST_SCALARS[k%3]);
+        subresult &= ristretto255_point_eq(out_rist2, &many_out[0]);
+        result &= subresult;
+
+        #ifdef VERBOSE_FLAG
+        if (!subresult){
+                printf("SCALARMULT_STEP TEST no.%d: FAILED! Error was found when testing step size %d\n",k,step_sizes[k]);
+        }
+        else{
+            printf("SCALARMULT_STEP TEST no.%d: SUCCESS!\n",k);
+        }
+        #endif  
+    }
+
+
+    // testing cache of decoded points, 15 encodings are decoded
+    // twice through cache with 64 entries (so nothing is evicted),
+    // results and exact hit/miss counters are checked, invalid
+    // encoding must not be cached
+    ristretto255_cache point_cache;
+    ristretto255_cache_entry cache_entries[64];
+    ristretto255_cache_table cache_tables[2];
+    u8 cache_hash_key[RISTRETTO255_CACHE_KEY_SIZE] = {0x3f, 0x11, 0xa0, 0x5c, 0x91, 0x07, 0x2e, 0xd4, 0x68, 0xbb, 0x10, 0x75, 0xe3, 0x4a, 0x09, 0xcf};
+    size_t cache_hits, cache_misses;
+
+    subresult = RISTRETTO255_CACHE_CAPACITY(sizeof(cache_entries) + sizeof(cache_tables), 2) == 64;
+    subresult &= ristretto255_cache_init(&point_cache, cache_entries, 64, cache_tables, 2, cache_hash_key, 2) == 0;
+    for (int k = 0; k < 2; ++k)
+    {
+        for (int i = 1; i < 16; ++i)
+        {
+            subresult &= ristretto255_cache_decode(&point_cache, out_rist, SMALL_MULTIPLES_OF_GENERATOR_VECTORS[i]) == 0;
+            subresult &= ristretto255_point_eq(out_rist, &multiples[i]);
+        }
+    }
+    subresult &= ristretto255_cache_decode(&point_cache, out_rist, negative_xy[0]) == 1;
+    subresult &= ristretto255_cache_decode(&point_cache, out_rist, negative_xy[0]) == 1;
+    ristretto255_cache_stats(&point_cache, &cache_hits, &cache_misses);
+    // 15 first decodings and 2 invalid encodings miss
+    subresult &= cache_hits == 15 && cache_misses == 17;
+
+    // hot entry is promoted to precomputed table after 2 hits
+    // (except LOW_STACK_FLAG profile, which never promotes)
+    for (int k = 0; k < 4; ++k)
+    {
+        subresult &= ristretto255_cache_scalarmult(&point_cache, &many_out[0], RISTRETTO255_BASEPOINT, TEST_SCALARS[k%3]) == 0;
+        output_ristretto_point = multiples[1];
+        ristretto255_scalarmult(out_rist2, out_rist, TEST_SCALARS[k%3]);
+        subresult &= ristretto255_point_eq(out_rist2, &many_out[0]);
+    }
+    int promoted = 0;
+    u8 cache_key[BYTES_ELEM_SIZE], cache_key2[BYTES_ELEM_SIZE];
+    for (int i = 0; i < 64; ++i){
+        if (cache_entries[i].is_valid && cache_entries[i].table_slot != 0
+            && cache_tables[cache_entries[i].table_slot - 1].is_valid){
+            cache_key_bytes(cache_key, cache_tables[cache_entries[i].table_slot - 1].key);
+            promoted |= bytes_eq_32(cache_key, RISTRETTO255_BASEPOINT);
+        }
+    }
+    // basepoint is already cached, so all 4 multiplications hit
+    ristretto255_cache_stats(&point_cache, &cache_hits, &cache_misses);
+    subresult &= cache_hits == 19 && cache_misses == 17;
+    #ifdef LOW_STACK_FLAG
+    subresult &= !promoted;
+    #else
+    subresult &= promoted;
+    #endif
+    result &= subresult;
+
+    #ifdef VERBOSE_FLAG
+    if (!subresult){
+            printf("POINT_CACHE TEST: FAILED! hits=%zu, misses=%zu\n", cache_hits, cache_misses);
+    }
+    else{
+        printf("POINT_CACHE TEST: SUCCESS!\n");
+    }
+    #endif  
+
+
+    // testing point handles with memoized encoding, handles of
+    // computed (projective) multiples are encoded in batch and
+    // compared with decoded handles
+    ristretto255_handle computed_handles[16];
+    ristretto255_handle decoded_handle;
+    for (int i = 0; i < 16; ++i){
+        ristretto255_handle_set_point(&computed_handles[i], &projective_multiples[i]);
+    }
+    ristretto255_handle_encode_batch(computed_handles, 8);
+    for (int i = 0; i < 16; ++i)
+    {
+        subresult = computed_handles[i].has_encoding == (i < 8);
+        subresult &= ristretto255_handle_decode(&decoded_handle, SMALL_MULTIPLES_OF_GENERATOR_VECTORS[i]) == 0;
+        subresult &= decoded_handle.is_validated && !computed_handles[i].is_validated;
+        subresult &= ristretto255_handle_eq(&decoded_handle, &computed_handles[i]);
+        subresult &= !ristretto255_handle_eq(&decoded_handle, &computed_handles[(i+1)%16]);
+        ristretto255_handle_encode(bytes_out_, &computed_handles[i]);
+        subresult &= bytes_eq_32(bytes_out_, SMALL_MULTIPLES_OF_GENERATOR_VECTORS[i]);
+        subresult &= computed_handles[i].has_encoding;
+        result &= subresult;
+
+        #ifdef VERBOSE_FLAG
+        if (!subresult){
+                printf("POINT_HANDLE TEST no.%d: FAILED! Error was found when testing handle of %d*B\n",i,i);
+        }
+        else{
+            printf("POINT_HANDLE TEST no.%d: SUCCESS!\n",i);
+        }
+        #endif  
+    }
+    subresult = ristretto255_handle_decode(&decoded_handle, negative_xy[0]) == 1;
+    subresult &= !decoded_handle.has_encoding && !decoded_handle.is_validated;
+    result &= subresult;
+
+
+    // testing structure-of-arrays point batch, 15 multiples are
+    // loaded into 2 blocks (so second block is not full) and stored
+    // back, point i must be in lane i % RISTRETTO255_BATCH_LANES of
+    // block i / RISTRETTO255_BATCH_LANES
+    ristretto255_point_batch point_batch[RISTRETTO255_BATCH_BLOCKS(15)];
+    ristretto255_point batch_points[15];
+    subresult = RISTRETTO255_BATCH_BLOCKS(15) == 2 && RISTRETTO255_BATCH_BLOCKS(16) == 2 && RISTRETTO255_BATCH_BLOCKS(17) == 3;
+    ristretto255_point_batch_load(point_batch, multiples+1, 15);
+    ristretto255_point_batch_store(batch_points, point_batch, 15);
+    for (int i = 0; i < 15; ++i){
+        subresult &= ristretto255_point_eq(&batch_points[i], &multiples[i+1]);
+        subresult &= point_batch[i / RISTRETTO255_BATCH_LANES].t[0][i % RISTRETTO255_BATCH_LANES] == multiples[i+1].t[0];
+    }
+    result &= subresult;
+
+    #ifdef VERBOSE_FLAG
+    if (!subresult){
+            printf("POINT_BATCH TEST: FAILED!\n");
+    }
+    else{
+        printf("POINT_BATCH TEST: SUCCESS!\n");
+    }
+    #endif  
+
+
+    // testing SHA-512 and derivation of generators, generators
+    // derived in one call must be the same as generators derived
+    // in two ranges, tables must give the same scalarmult
+    u8 sha512_digest[HASH_BYTES_SIZE];
+    const char* sha512_msg = "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu";
+    sha512(sha512_digest, (const u8*)"abc", 3);
+    subresult = bytes_eq_32(sha512_digest, SHA512_VECTORS_RESULT[0]) & bytes_eq_32(sha512_digest+32, SHA512_VECTORS_RESULT[0]+32);
+    sha512(sha512_digest, (const u8*)sha512_msg, 112);
+    subresult &= bytes_eq_32(sha512_digest, SHA512_VECTORS_RESULT[1]) & bytes_eq_32(sha512_digest+32, SHA512_VECTORS_RESULT[1]+32);
+
+    ristretto255_point generators[8];
+    ristretto255_table generator_tables[2];
+    const u8 generator_label[] = "ristretto255 test generators";
+    ristretto255_derive_generators(generators, generator_label, sizeof(generator_label) - 1, 0, 6);
+    ristretto255_derive_generators(generators+6, generator_label, sizeof(generator_label) - 1, 2, 2);
+    subresult &= ristretto255_point_eq(&generators[2], &generators[6]);
+    subresult &= ristretto255_point_eq(&generators[3], &generators[7]);
+    for (int i = 0; i < 6; ++i){
+        subresult &= !ristretto255_point_eq(&generators[i], &generators[(i+1)%6]);
+        subresult &= !ristretto255_is_identity(&generators[i]);
+    }
+    ristretto255_derive_generators(generators+6, generator_label, sizeof(generator_label) - 2, 2, 1);
+    subresult &= !ristretto255_point_eq(&generators[2], &generators[6]);
+    ristretto255_derive_generator_tables(generator_tables, generator_label, sizeof(generator_label) - 1, 4, 2);
+    for (int i = 0; i < 2; ++i){
+        ristretto255_scalarmult_table(out_rist2, generator_tables+i, TEST_SCALARS[2]);
+        output_ristretto_point = generators[4+i];
+        ristretto255_scalarmult(&many_out[0], out_rist, TEST_SCALARS[2]);
+        subresult &= ristretto255_point_eq(&many_out[0], out_rist2);
+    }
+    result &= subresult;
+
+    #ifdef VERBOSE_FLAG
+    if (!subresult){
+            printf("DERIVE_GENERATORS TEST: FAILED!\n");
+    }
+    else{
+        printf("DERIVE_GENERATORS TEST: SUCCESS!\n");
+    }
+    #endif
+
+
+    // testing table file, file with generator tables is parsed in
+    // place (tables point into buffer), corrupted, truncated file
+    // and file of other version must be rejected, on POSIX the same
+    // file is also written to disk and mapped
+    _Alignas(64) u8 table_file_buf[RISTRETTO255_TABLE_FILE_HEADER_SIZE + 2*sizeof(ristretto255_table)];
+    ristretto255_table_file table_file;
+    u8* table_file_bytes = (u8*)generator_tables;
+    for (int i = 0; i < (int)sizeof(table_file_buf); ++i){
+        table_file_buf[i] = 0;
+    }
+    subresult = ristretto255_table_file_header(table_file_buf, generator_tables, 2, RISTRETTO255_TABLE_FILE_GENERATORS) == 0;
+    for (int i = 0; i < (int)(2*sizeof(ristretto255_table)); ++i){
+        table_file_buf[RISTRETTO255_TABLE_FILE_HEADER_SIZE + i] = table_file_bytes[i];
+    }
+    subresult &= ristretto255_table_file_parse(&table_file, table_file_buf, sizeof(table_file_buf)) == 0;
+    subresult &= table_file.count == 2 && table_file.tag == RISTRETTO255_TABLE_FILE_GENERATORS;
+    subresult &= (const u8*)table_file.tables == table_file_buf + RISTRETTO255_TABLE_FILE_HEADER_SIZE;
+    ristretto255_scalarmult_table(out_rist2, &table_file.tables[1], TEST_SCALARS[2]);
+    output_ristretto_point = generators[5];
+    ristretto255_scalarmult(&many_out[0], out_rist, TEST_SCALARS[2]);
+    subresult &= ristretto255_point_eq(&many_out[0], out_rist2);
+
+    table_file_buf[RISTRETTO255_TABLE_FILE_HEADER_SIZE + 100] ^= 1;
+    subresult &= ristretto255_table_file_parse(&table_file, table_file_buf, sizeof(table_file_buf)) == 1;
+    subresult &= table_file.tables == NULL && table_file.count == 0;
+    table_file_buf[RISTRETTO255_TABLE_FILE_HEADER_SIZE + 100] ^= 1;
+    subresult &= ristretto255_table_file_parse(&table_file, table_file_buf, sizeof(table_file_buf) - 1) == 1;
+    table_file_buf[8] = RISTRETTO255_TABLE_FILE_VERSION + 1;
+    subresult &= ristretto255_table_file_parse(&table_file, table_file_buf, sizeof(table_file_buf)) == 1;
+    table_file_buf[8] = RISTRETTO255_TABLE_FILE_VERSION;
+    subresult &= ristretto255_table_file_parse(&table_file, table_file_buf, sizeof(table_file_buf)) == 0;
+
+    #ifdef TABLE_FILE_MMAP_FLAG
+    FILE* table_file_disk = fopen("table_file_test.tbl", "wb");
+    subresult &= table_file_disk != NULL && fwrite(table_file_buf, 1, sizeof(table_file_buf), table_file_disk) == sizeof(table_file_buf);
+    if (table_file_disk != NULL){
+        fclose(table_file_disk);
+    }
+    subresult &= ristretto255_table_file_map(&table_file, "table_file_test.tbl") == 0;
+    subresult &= table_file.count == 2 && table_file.map != NULL;
+    if (table_file.count == 2){
+        ristretto255_scalarmult_table(out_rist2, &table_file.tables[1], TEST_SCALARS[2]);
+        subresult &= ristretto255_point_eq(&many_out[0], out_rist2);
+    }
+    ristretto255_table_file_unmap(&table_file);
+    remove("table_file_test.tbl");
+    subresult &= ristretto255_table_file_map(&table_file, "table_file_test.tbl") == 1;
+    #endif
+    result &= subresult;
+
+    #ifdef VERBOSE_FLAG
+    if (!subresult){
+            printf("TABLE_FILE TEST: FAILED!\n");
+    }
+    else{
+        printf("TABLE_FILE TEST: SUCCESS!\n");
+    }
+    #endif
+
+
+    // testing thread pool, batches are larger than one chunk, so
+    // they are split across workers, results must be in order and
+    // the same as sequential calls, invalid encodings (negative_xy)
+    // must be reported only in their own status
+    ristretto255_pool pool;
+    u8 pool_bytes[24][BYTES_ELEM_SIZE];
+    u8 pool_scalars[16][BYTES_ELEM_SIZE];
+    u8 pool_hashes[21][HASH_BYTES_SIZE];
+    u8 pool_out[24][BYTES_ELEM_SIZE];
+    ristretto255_point pool_points[24];
+    int pool_status[24];
+    ristretto255_scalar pool_scalar;
+    for (int i = 0; i < 24; ++i){
+        for (int j = 0; j < BYTES_ELEM_SIZE; ++j){
+            pool_bytes[i][j] = i < 16 ? SMALL_MULTIPLES_OF_GENERATOR_VECTORS[i][j] : negative_xy[i-16][j];
+            if (i < 16){
+                pool_scalars[i][j] = i < 15 ? TEST_SCALARS[i%3][j] ^ (u8)i : 0xff;
+            }
+        }
+    }
+    for (int i = 0; i < 21; ++i){
+        for (int j = 0; j < HASH_BYTES_SIZE; ++j){
+            pool_hashes[i][j] = MAP_VECTORS[i%7][j];
+        }
+    }
+    subresult = ristretto255_pool_init(&pool, RISTRETTO255_POOL_MAX_WORKERS + 1, NULL) == 1;
+    // destroy after failed init does nothing
+    ristretto255_pool_destroy(&pool);
+    #ifdef THREAD_POOL_FLAG
+    subresult &= ristretto255_pool_init(&pool, 3, NULL) == 0 && pool.workers == 3;
+    #else
+    subresult &= ristretto255_pool_init(&pool, 0, NULL) == 0;
+    #endif
+    for (int k = 0; k < 2; ++k){
+        // k = 0 workers, k = 1 sequential (pool NULL)
+        ristretto255_pool* test_pool = k == 0 ? &pool : NULL;
+        subresult &= ristretto255_pool_decode(test_pool, pool_points, (const u8 (*)[BYTES_ELEM_SIZE])pool_bytes, pool_status, 24) == 1;
+        for (int i = 0; i < 24; ++i){
+            subresult &= pool_status[i] == (i >= 16);
+            if (i < 16){
+                subresult &= ristretto255_point_eq(&pool_points[i], &multiples[i]);
+            }
+        }
+        subresult &= ristretto255_pool_encode(test_pool, pool_out, projective_multiples, pool_status, 16) == 0;
+        for (int i = 0; i < 16; ++i){
+            subresult &= pool_status[i] == 0 && bytes_eq_32(pool_out[i], SMALL_MULTIPLES_OF_GENERATOR_VECTORS[i]);
+        }
+        // last scalar is not canonical, it is multiplied anyway
+        // and reported only in its own status
+        subresult &= ristretto255_pool_scalarmult(test_pool, pool_points, multiples, (const u8 (*)[BYTES_ELEM_SIZE])pool_scalars, pool_status, 16) == 1;
+        for (int i = 0; i < 16; ++i){
+            output_ristretto_point = multiples[i];
+            ristretto255_scalarmult(out_rist2, out_rist, pool_scalars[i]);
+            subresult &= ristretto255_point_eq(out_rist2, &pool_points[i]);
+            subresult &= pool_status[i] == ristretto255_scalar_decode(&pool_scalar, pool_scalars[i]);
+        }
+        subresult &= pool_status[15] == 1;
+        subresult &= ristretto255_pool_hash_to_group(test_pool, pool_out, (const u8 (*)[HASH_BYTES_SIZE])pool_hashes, pool_status, 21) == 0;
+        for (int i = 0; i < 21; ++i){
+            subresult &= pool_status[i] == 0 && bytes_eq_32(pool_out[i], MAP_VECTORS_RESULT[i%7]);
+        }
+    }
+
+    // workers share small cache (2 sets, 2 table slots, promotion
+    // after first hit), so lookups, insertions, evictions and
+    // promotions of the same encodings run concurrently
+    ristretto255_cache_entry shared_entries[2*RISTRETTO255_CACHE_WAYS];
+    ristretto255_cache_table shared_tables[2];
+    ristretto255_point cache_products[16];
+    cache_pool_job cache_job = {&point_cache, (const u8 (*)[BYTES_ELEM_SIZE])pool_bytes, multiples, cache_products, pool_scalars[0]};
+    for (int i = 0; i < 16; ++i){
+        output_ristretto_point = multiples[i];
+        ristretto255_scalarmult(&cache_products[i], out_rist, pool_scalars[0]);
+    }
+    subresult &= ristretto255_cache_init(&point_cache, shared_entries, 2*RISTRETTO255_CACHE_WAYS, shared_tables, 2, cache_hash_key, 1) == 0;
+    subresult &= ristretto255_pool_run(&pool, cache_pool_task, &cache_job, 2048) == 0;
+    ristretto255_cache_stats(&point_cache, &cache_hits, &cache_misses);
+    subresult &= cache_hits + cache_misses == 2048 && cache_hits > 0;
+    // no encoding is cached twice in one set
+    for (int i = 0; i < 2*RISTRETTO255_CACHE_WAYS; ++i){
+        for (int j = i + 1; j < 2*RISTRETTO255_CACHE_WAYS && j / RISTRETTO255_CACHE_WAYS == i / RISTRETTO255_CACHE_WAYS; ++j){
+            cache_key_bytes(cache_key, shared_entries[i].key);
+            cache_key_bytes(cache_key2, shared_entries[j].key);
+            subresult &= !(shared_entries[i].is_valid && shared_entries[j].is_valid && bytes_eq_32(cache_key, cache_key2));
+        }
+    }
+    #ifndef LOW_STACK_FLAG
+    subresult &= shared_tables[0].is_valid || shared_tables[1].is_valid;
+    #endif
+    ristretto255_pool_destroy(&pool);
+    // second destroy does nothing
+    ristretto255_pool_destroy(&pool);
+    result &= subresult;
+
+    #ifdef VERBOSE_FLAG
+    if (!subresult){
+            printf("THREAD_POOL TEST: FAILED!\n");
+    }
+    else{
+        printf("THREAD_POOL TEST: SUCCESS!\n");
+    }
+    #endif
+
+
+    // testing expand_message_xmd and hash_to_group_xmd, result of
+    // one-shot, ctx and batch version must be the same as 
+    // hash_to_group of expanded message
+    xmd_ctx test_xmd_ctx;
+    u8 xmd_out[2*HASH_BYTES_SIZE];
+    u8 xmd_group_out[2][BYTES_ELEM_SIZE];
+    u8 oversize_dst[300];
+    const u8 xmd_dst[] = "QUUX-V01-CS02-with-expander-SHA512-256";
+    const u8* xmd_msgs[2] = {(const u8*)"abc", (const u8*)"abcdef0123456789"};
+    const size_t xmd_msg_lens[2] = {3, 16};
+    xmd_init(&test_xmd_ctx, xmd_dst, sizeof(xmd_dst) - 1);
+    subresult = 1;
+    for (int i = 0; i < 2; ++i){
+        subresult &= expand_message_xmd(xmd_out, (i+1)*HASH_BYTES_SIZE, xmd_msgs[i], xmd_msg_lens[i], &test_xmd_ctx) == 0;
+        for (int j = 0; j < (i+1)*2; ++j){
+            subresult &= bytes_eq_32(xmd_out+32*j, XMD_VECTORS_RESULT[i]+32*j);
+        }
+    }
+    subresult &= expand_message_xmd(xmd_out, 0, xmd_msgs[0], 3, &test_xmd_ctx) == 1;
+    subresult &= expand_message_xmd(xmd_out, XMD_MAX_OUT_SIZE + 1, xmd_msgs[0], 3, &test_xmd_ctx) == 1;
+    for (int i = 0; i < 300; ++i){
+        oversize_dst[i] = 'a';
+    }
+    xmd_init(&test_xmd_ctx, oversize_dst, 300);
+    expand_message_xmd(xmd_out, HASH_BYTES_SIZE, xmd_msgs[0], 3, &test_xmd_ctx);
+    subresult &= bytes_eq_32(xmd_out, XMD_OVERSIZE_DST_RESULT) & bytes_eq_32(xmd_out+32, XMD_OVERSIZE_DST_RESULT+32);
+
+    xmd_init(&test_xmd_ctx, xmd_dst, sizeof(xmd_dst) - 1);
+    ristretto255_hash_to_group_xmd_batch(xmd_group_out, xmd_msgs, xmd_msg_lens, 2, &test_xmd_ctx);
+    hash_to_group(bytes_out_, XMD_VECTORS_RESULT[0]);
+    subresult &= bytes_eq_32(xmd_group_out[0], bytes_out_);
+    ristretto255_hash_to_group_xmd(bytes_out_, xmd_msgs[1], xmd_msg_lens[1], xmd_dst, sizeof(xmd_dst) - 1);
+    subresult &= bytes_eq_32(xmd_group_out[1], bytes_out_);
+    result &= subresult;
+
+    #ifdef VERBOSE_FLAG
+    if (!subresult){
+            printf("HASH_TO_GROUP_XMD TEST: FAILED!\n");
+    }
+    else{
+        printf("HASH_TO_GROUP_XMD TEST: SUCCESS!\n");
+    }
+    #endif
+
+
     // testing hash_to_group
     for (int i = 0; i < 7; ++i){
 
@@ -224,6 +942,49 @@ int main(){
     }
 
 
+    // testing _ws variants, all calls share one workspace and results
+    // must be the same as results of plain functions, workspace is
+    // wiped only once at the end
+    ristretto255_ws ws;
+    ristretto255_point ws_p, ws_q, ws_r, ws_tmp;
+    u8 ws_acc = 0;
+    subresult = 1;
+    for (int i = 0; i < 7; ++i){
+        hash_to_group_ws(bytes_out_, MAP_VECTORS[i], &ws);
+        subresult &= bytes_eq_32(bytes_out_, MAP_VECTORS_RESULT[i]);
+        subresult &= ristretto255_decode_ws(&ws_p, MAP_VECTORS_RESULT[i], &ws) == 0;
+        ristretto255_encode_ws(bytes_out_, &ws_p, &ws);
+        subresult &= bytes_eq_32(bytes_out_, MAP_VECTORS_RESULT[i]);
+    }
+    // 2P + P
+    ristretto255_point_addition_ws(&ws_q, &ws_p, &ws_p, &ws);
+    ristretto255_point_addition_ws(&ws_q, &ws_q, &ws_p, &ws);
+    ristretto255_point_addition(&ws_r, &ws_p, &ws_p);
+    ristretto255_point_addition(&ws_r, &ws_r, &ws_p);
+    subresult &= ristretto255_point_eq(&ws_q, &ws_r);
+    // 15P (scalarmult modifies its second argument)
+    ws_tmp = ws_p;
+    ristretto255_scalarmult_ws(&ws_q, &ws_tmp, INTG, &ws);
+    ws_tmp = ws_p;
+    ristretto255_scalarmult(&ws_r, &ws_tmp, INTG);
+    subresult &= ristretto255_point_eq(&ws_q, &ws_r);
+    ristretto255_ws_wipe(&ws);
+    for (size_t i = 0; i < sizeof(ws); ++i){
+        ws_acc |= ((const u8*)&ws)[i];
+    }
+    subresult &= ws_acc == 0;
+    result &= subresult;
+
+    #ifdef VERBOSE_FLAG
+    if (!subresult){
+            printf("WORKSPACE (_ws) VARIANTS TEST: FAILED!\n");
+    }
+    else{
+        printf("WORKSPACE (_ws) VARIANTS TEST: SUCCESS!\n");
+    }
+    #endif
+
+
     //testing if vector is negative 
     for (int i = 0; i < 8; ++i){
         unpack25519(in,test_negative_vectors[i]);
@@ -341,6 +1102,265 @@ int main(){
     #endif   
 
 
+    // testing that all variants of modular inverse (mod L) give
+    // the same result (including inverse of 0, which is 0)
+    u8 inverse_chain[BYTES_ELEM_SIZE], inverse_barrett[BYTES_ELEM_SIZE], inverse_montgomery[BYTES_ELEM_SIZE];
+    u8 zero_scalar[BYTES_ELEM_SIZE] = {0};
+    subresult = 1;
+    for (int i = 0; i < 4; ++i){
+        const u8* inverse_in = i < 3 ? TEST_SCALARS[i] : zero_scalar;
+        inverse_mod_l_chain(inverse_chain, inverse_in);
+        inverse_mod_l(inverse_barrett, inverse_in);
+        crypto_x25519_inverse(inverse_montgomery, inverse_in);
+        subresult &= bytes_eq_32(inverse_chain, inverse_barrett) & bytes_eq_32(inverse_chain, inverse_montgomery);
+    }
+    subresult &= bytes_eq_32(inverse_chain, zero_scalar);
+    result &= subresult;
+
+    #ifdef VERBOSE_FLAG
+    if (!subresult){
+            printf("ModL INVERSE VARIANTS TEST: FAILED!\n");
+    }
+    else{
+        printf("ModL INVERSE VARIANTS TEST: SUCCESS!\n");
+    }
+    #endif
+
+
+    // testing batch modular inverse (mod L), every output must be
+    // the same as output of modl_l_inverse, zero (0 and L) in the 
+    // middle of batch must not affect other outputs
+    u8 inverse_batch_in[6][BYTES_ELEM_SIZE] = {{0}};
+    u8 inverse_batch_out[6][BYTES_ELEM_SIZE];
+    for (int i = 0; i < BYTES_ELEM_SIZE; ++i){
+        inverse_batch_in[0][i] = TEST_SCALARS[0][i];
+        inverse_batch_in[2][i] = TEST_SCALARS[1][i];
+        inverse_batch_in[4][i] = TEST_SCALARS[2][i];
+        inverse_batch_in[5][i] = iner[i];
+    }
+    // inverse_batch_in[3] = L
+    const u8 group_order[16] = {0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14};
+    for (int i = 0; i < 16; ++i){
+        inverse_batch_in[3][i] = group_order[i];
+    }
+    inverse_batch_in[3][31] = 0x10;
+    modl_l_inverse_batch(inverse_batch_out, inverse_batch_in, 6);
+    subresult = 1;
+    for (int i = 0; i < 6; ++i){
+        modl_l_inverse(inverse_chain, inverse_batch_in[i]);
+        subresult &= bytes_eq_32(inverse_chain, inverse_batch_out[i]);
+    }
+    subresult &= bytes_eq_32(inverse_batch_out[1], zero_scalar) & bytes_eq_32(inverse_batch_out[3], zero_scalar);
+    modl_l_inverse_batch(inverse_batch_out, inverse_batch_in+2, 1);
+    modl_l_inverse(inverse_chain, inverse_batch_in[2]);
+    subresult &= bytes_eq_32(inverse_chain, inverse_batch_out[0]);
+    result &= subresult;
+
+    #ifdef VERBOSE_FLAG
+    if (!subresult){
+            printf("ModL INVERSE BATCH TEST: FAILED!\n");
+    }
+    else{
+        printf("ModL INVERSE BATCH TEST: SUCCESS!\n");
+    }
+    #endif
+
+
+    // testing scalar arithmetic (normal and Montgomery form)
+    ristretto255_scalar sc_a, sc_b, sc_r, sc_t;
+    ristretto255_scalar_mont sc_ma, sc_mb, sc_mr;
+    subresult = ristretto255_scalar_decode(&sc_a, SCALAR_VECTORS[0]) == 0;
+    subresult &= ristretto255_scalar_decode(&sc_b, SCALAR_VECTORS[1]) == 0;
+    ristretto255_scalar_add(&sc_r, &sc_a, &sc_b);
+    ristretto255_scalar_encode(bytes_out_, &sc_r);
+    subresult &= bytes_eq_32(bytes_out_, SCALAR_VECTORS[2]);
+    ristretto255_scalar_sub(&sc_r, &sc_a, &sc_b);
+    ristretto255_scalar_encode(bytes_out_, &sc_r);
+    subresult &= bytes_eq_32(bytes_out_, SCALAR_VECTORS[3]);
+    ristretto255_scalar_add(&sc_t, &sc_r, &sc_b);
+    subresult &= ristretto255_scalar_eq(&sc_t, &sc_a) & !ristretto255_scalar_eq(&sc_t, &sc_b);
+    ristretto255_scalar_mul(&sc_r, &sc_a, &sc_b);
+    ristretto255_scalar_encode(bytes_out_, &sc_r);
+    subresult &= bytes_eq_32(bytes_out_, SCALAR_VECTORS[4]);
+    // a * b in Montgomery form
+    ristretto255_scalar_to_mont(&sc_ma, &sc_a);
+    ristretto255_scalar_to_mont(&sc_mb, &sc_b);
+    ristretto255_scalar_mont_mul(&sc_mr, &sc_ma, &sc_mb);
+    ristretto255_scalar_from_mont(&sc_t, &sc_mr);
+    subresult &= ristretto255_scalar_eq(&sc_t, &sc_r);
+    // (a + b)^2 - (a - b)^2 = 4ab in both forms
+    ristretto255_scalar_mont_add(&sc_mr, &sc_ma, &sc_mb);
+    ristretto255_scalar_mont_square(&sc_mr, &sc_mr);
+    ristretto255_scalar_mont_sub(&sc_ma, &sc_ma, &sc_mb);
+    ristretto255_scalar_mont_square(&sc_ma, &sc_ma);
+    ristretto255_scalar_mont_sub(&sc_mr, &sc_mr, &sc_ma);
+    ristretto255_scalar_from_mont(&sc_t, &sc_mr);
+    ristretto255_scalar_add(&sc_r, &sc_r, &sc_r);
+    ristretto255_scalar_add(&sc_r, &sc_r, &sc_r);
+    subresult &= ristretto255_scalar_eq(&sc_t, &sc_r);
+    // the same chain with one caller-owned workspace, 4ab * a^2 = 4a^3b
+    ristretto255_mont_ws mont_ws;
+    ristretto255_scalar_to_mont_ws(&sc_ma, &sc_a, &mont_ws);
+    ristretto255_scalar_to_mont_ws(&sc_mr, &sc_r, &mont_ws);
+    ristretto255_scalar_mont_square_ws(&sc_mb, &sc_ma, &mont_ws);
+    ristretto255_scalar_mont_mul_ws(&sc_mr, &sc_mr, &sc_mb, &mont_ws);
+    ristretto255_scalar_from_mont_ws(&sc_t, &sc_mr, &mont_ws);
+    ristretto255_mont_ws_wipe(&mont_ws);
+    ristretto255_scalar_square(&sc_b, &sc_a);
+    ristretto255_scalar_mul(&sc_r, &sc_r, &sc_b);
+    subresult &= ristretto255_scalar_eq(&sc_t, &sc_r);
+    ristretto255_scalar_square(&sc_t, &sc_a);
+    ristretto255_scalar_mul(&sc_r, &sc_a, &sc_a);
+    subresult &= ristretto255_scalar_eq(&sc_t, &sc_r);
+    // a + (-a) = 0, a * a^-1 = 1
+    ristretto255_scalar_neg(&sc_r, &sc_a);
+    ristretto255_scalar_add(&sc_r, &sc_r, &sc_a);
+    ristretto255_scalar_encode(bytes_out_, &sc_r);
+    subresult &= bytes_eq_32(bytes_out_, zero_scalar);
+    ristretto255_scalar_invert(&sc_r, &sc_a);
+    ristretto255_scalar_mul(&sc_r, &sc_r, &sc_a);
+    ristretto255_scalar_encode(bytes_out_, &sc_r);
+    subresult &= bytes_out_[0] == 1 && !bytes_eq_32(bytes_out_, zero_scalar);
+    bytes_out_[0] = 0;
+    subresult &= bytes_eq_32(bytes_out_, zero_scalar);
+    // canonical decoding, L-1 is accepted, L is rejected
+    subresult &= ristretto255_scalar_decode(&sc_r, SCALAR_VECTORS[5]) == 0;
+    subresult &= ristretto255_scalar_decode(&sc_r, inverse_batch_in[3]) == 1;
+    ristretto255_scalar_encode(bytes_out_, &sc_r);
+    subresult &= bytes_eq_32(bytes_out_, zero_scalar);
+    result &= subresult;
+
+    #ifdef VERBOSE_FLAG
+    if (!subresult){
+            printf("SCALAR ARITHMETIC TEST: FAILED!\n");
+    }
+    else{
+        printf("SCALAR ARITHMETIC TEST: SUCCESS!\n");
+    }
+    #endif
+
+
+    // testing reduction of 64B hashes into scalars, result must be
+    // the same as mod_l (Barrett), including 2^512-1 and batch variant
+    u8 wide_in[8][HASH_BYTES_SIZE];
+    u32 wide_words[16];
+    ristretto255_scalar wide_out[8];
+    for (int i = 0; i < 8; ++i){
+        for (int j = 0; j < HASH_BYTES_SIZE; ++j){
+            wide_in[i][j] = i < 7 ? MAP_VECTORS[i][j] : 0xff;
+        }
+    }
+    ristretto255_scalar_from_wide_bytes_batch(wide_out, wide_in, 8);
+    subresult = 1;
+    for (int i = 0; i < 8; ++i){
+        for (int j = 0; j < 16; ++j){
+            wide_words[j] = (u32)wide_in[i][4*j] | (u32)wide_in[i][4*j+1] << 8 | (u32)wide_in[i][4*j+2] << 16 | (u32)wide_in[i][4*j+3] << 24;
+        }
+        mod_l(inverse_chain, wide_words);
+        ristretto255_scalar_from_wide_bytes(&sc_r, wide_in[i]);
+        ristretto255_scalar_encode(bytes_out_, &sc_r);
+        subresult &= bytes_eq_32(bytes_out_, inverse_chain) & ristretto255_scalar_eq(&sc_r, &wide_out[i]);
+    }
+    result &= subresult;
+
+    #ifdef VERBOSE_FLAG
+    if (!subresult){
+            printf("SCALAR FROM WIDE BYTES TEST: FAILED!\n");
+    }
+    else{
+        printf("SCALAR FROM WIDE BYTES TEST: SUCCESS!\n");
+    }
+    #endif
+
+
+    // testing scalar vector routines against naive loops of
+    // ristretto255_scalar_mul/add, vectors are longer than lazy
+    // accumulation (32 products) and end with L-1 (largest products),
+    // Lagrange coefficients must interpolate f(0) from 3 shares
+    ristretto255_scalar vec_a[40], vec_b[40], vec_x[3], vec_y[3], vec_l[3];
+    ristretto255_scalar_decode(&vec_a[0], SCALAR_VECTORS[0]);
+    ristretto255_scalar_decode(&vec_b[0], SCALAR_VECTORS[1]);
+    for (int i = 1; i < 40; ++i){
+        if (i < 30){
+            ristretto255_scalar_mul(&vec_a[i], &vec_a[i-1], &vec_b[0]);
+            ristretto255_scalar_add(&vec_b[i], &vec_b[i-1], &vec_a[i]);
+        }
+        else{
+            ristretto255_scalar_decode(&vec_a[i], SCALAR_VECTORS[5]);
+            ristretto255_scalar_decode(&vec_b[i], SCALAR_VECTORS[5]);
+        }
+    }
+    ristretto255_scalar_inner_product(&sc_r, vec_a, vec_b, 40);
+    ristretto255_scalar_mul(&sc_t, &vec_a[0], &vec_b[0]);
+    for (int i = 1; i < 40; ++i){
+        ristretto255_scalar_mul(&sc_a, &vec_a[i], &vec_b[i]);
+        ristretto255_scalar_add(&sc_t, &sc_t, &sc_a);
+    }
+    subresult = ristretto255_scalar_eq(&sc_r, &sc_t);
+    // p(x) = sum vec_a[i] * x^i, x = vec_b[0]
+    ristretto255_scalar_poly_eval(&sc_r, vec_a, 40, &vec_b[0]);
+    sc_a = vec_b[0];
+    sc_t = vec_a[0];
+    for (int i = 1; i < 40; ++i){
+        ristretto255_scalar_mul(&sc_b, &vec_a[i], &sc_a);
+        ristretto255_scalar_add(&sc_t, &sc_t, &sc_b);
+        ristretto255_scalar_mul(&sc_a, &sc_a, &vec_b[0]);
+    }
+    subresult &= ristretto255_scalar_eq(&sc_r, &sc_t);
+    // shares y_i = f(x_i), x_i = 1, 2, 3 of f(x) = a_0 + a_1 x + a_2 x^2
+    for (int i = 0; i < 3; ++i){
+        bytes_out_[0] = (u8)(i+1);
+        for (int j = 1; j < BYTES_ELEM_SIZE; ++j){
+            bytes_out_[j] = 0;
+        }
+        ristretto255_scalar_decode(&vec_x[i], bytes_out_);
+        ristretto255_scalar_poly_eval(&vec_y[i], vec_a, 3, &vec_x[i]);
+    }
+    subresult &= ristretto255_scalar_lagrange_at_zero(vec_l, vec_x, 3) == 0;
+    ristretto255_scalar_inner_product(&sc_r, vec_l, vec_y, 3);
+    subresult &= ristretto255_scalar_eq(&sc_r, &vec_a[0]);
+    // duplicate point is rejected
+    vec_x[2] = vec_x[0];
+    subresult &= ristretto255_scalar_lagrange_at_zero(vec_l, vec_x, 3) == 1;
+    result &= subresult;
+
+    #ifdef VERBOSE_FLAG
+    if (!subresult){
+            printf("SCALAR VECTOR ROUTINES TEST: FAILED!\n");
+    }
+    else{
+        printf("SCALAR VECTOR ROUTINES TEST: SUCCESS!\n");
+    }
+    #endif
+
+
+    // testing multi-lane scalar kernels, every lane must be the same
+    // as single-lane function (37 scalars = last chunk is not full)
+    ristretto255_scalar vec_r[40];
+    ristretto255_scalar_mul_batch(vec_r, vec_a, vec_b, 37);
+    subresult = 1;
+    for (int i = 0; i < 37; ++i){
+        ristretto255_scalar_mul(&sc_t, &vec_a[i], &vec_b[i]);
+        subresult &= ristretto255_scalar_eq(&sc_t, &vec_r[i]);
+    }
+    ristretto255_scalar_add_batch(vec_r, vec_r, vec_a, 37);
+    for (int i = 0; i < 37; ++i){
+        ristretto255_scalar_mul(&sc_t, &vec_a[i], &vec_b[i]);
+        ristretto255_scalar_add(&sc_t, &sc_t, &vec_a[i]);
+        subresult &= ristretto255_scalar_eq(&sc_t, &vec_r[i]);
+    }
+    result &= subresult;
+
+    #ifdef VERBOSE_FLAG
+    if (!subresult){
+            printf("SCALAR MULTI-LANE KERNELS TEST: FAILED!\n");
+    }
+    else{
+        printf("SCALAR MULTI-LANE KERNELS TEST: SUCCESS!\n");
+    }
+    #endif
+
+
     // testing s = -1, which causes y = 0.
     result &= ristretto255_decode(out_rist,s_minus_1);
 
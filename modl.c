@@ -64,6 +64,114 @@ static const u32 L[8] = {
     0x00000000, 0x00000000, 0x00000000, 0x10000000,
 };
 
+#ifdef MODL_64BIT_FLAG
+// 64-bit limb backend, see MODL_64BIT_FLAG in config.h
+// Interface of all functions stays the same (arrays of u32 words),
+// inside we work with 4x 64-bit limbs and 128-bit products,
+// so e.g. 8x8 multiplication turns into 4x4 multiplication.
+#ifndef __SIZEOF_INT128__
+    #error "MODL_64BIT_FLAG requires compiler with unsigned __int128 support"
+#endif
+typedef unsigned __int128 u128;
+
+// L in 64-bit limbs
+static const u64 L64[4] = {
+    0x5812631a5cf5d3edULL, 0x14def9dea2f79cd6ULL,
+    0x0000000000000000ULL, 0x1000000000000000ULL,
+};
+
+static void store64_words(u32* dst, const u64* src, size_t size){
+    size_t i;
+    FOR (i, 0, size) {
+        dst[2*i]   = (u32)src[i];
+        dst[2*i+1] = (u32)(src[i] >> 32);
+    }
+}
+
+// i-th 64-bit limb of array of u32 words, helpers below read and
+// write limbs directly in u32 arrays, so no (secret) copies
+// are left on stack (macros, so they are inlined even with -Os)
+#define LIMB(a, i)          ((u64)(a)[2*(i)] | ((u64)(a)[2*(i)+1] << 32))
+#define SET_LIMB(a, i, v)   do { u64 v_ = (v); (a)[2*(i)] = (u32)v_; (a)[2*(i)+1] = (u32)(v_ >> 32); } while (0)
+
+//  p = a*b + p
+static void multiply(u32 p[16], const u32 a[8], const u32 b[8]){
+    size_t i, j;
+    FOR (i, 0, 4) {
+        u128 carry = 0;
+        FOR (j, 0, 4) {
+            carry  += LIMB(p, i+j) + (u128)LIMB(a, i) * LIMB(b, j);
+            SET_LIMB(p, i+j, (u64)carry);
+            carry >>= 64;
+        }
+        SET_LIMB(p, i+4, (u64)carry);
+    }
+}
+
+//  p = a^2
+// 6 cross products + 4 squares instead of 16 multiplications
+static void square(u32 p[16], const u32 a[8]){
+    size_t i, j;
+    u128 carry;
+
+    ZERO(i, p, 16);
+    // cross products
+    FOR (i, 0, 4) {
+        carry = 0;
+        FOR (j, i+1, 4) {
+            carry  += LIMB(p, i+j) + (u128)LIMB(a, i) * LIMB(a, j);
+            SET_LIMB(p, i+j, (u64)carry);
+            carry >>= 64;
+        }
+        SET_LIMB(p, i+4, (u64)carry);
+    }
+    // 2 * cross products
+    for (i = 15; i > 0; i--) {
+        p[i] = (p[i] << 1) | (p[i-1] >> 31);
+    }
+    p[0] = 0;
+    // + squares
+    carry = 0;
+    FOR (i, 0, 4) {
+        u128 sq = (u128)LIMB(a, i) * LIMB(a, i);
+        carry  += (u128)LIMB(p, 2*i) + (u64)sq;
+        SET_LIMB(p, 2*i, (u64)carry);
+        carry >>= 64;
+        carry  += (u128)LIMB(p, 2*i+1) + (u64)(sq >> 64);
+        SET_LIMB(p, 2*i+1, (u64)carry);
+        carry >>= 64;
+    }
+}
+
+//  p = s * L
+// L = 2^252 + L64[0..1], so we multiply only by 2 low limbs of L
+// and add s << 252.
+static void multiply_l(u32 p[16], const u32 s[8]){
+    size_t i, j;
+    u128 carry;
+
+    ZERO(i, p, 16);
+    FOR (i, 0, 4) {
+        carry = 0;
+        FOR (j, 0, 2) {
+            carry  += LIMB(p, i+j) + (u128)LIMB(s, i) * L64[j];
+            SET_LIMB(p, i+j, (u64)carry);
+            carry >>= 64;
+        }
+        SET_LIMB(p, i+2, (u64)carry);
+    }
+    // + s * 2^252 (2^252 = 2^60 * 2^(3*64))
+    carry = 0;
+    FOR (i, 0, 5) {
+        u64 shifted = (i < 4 ? LIMB(s, i) << 60 : 0) | (i > 0 ? LIMB(s, i-1) >> 4 : 0);
+        carry  += (u128)LIMB(p, i+3) + shifted;
+        SET_LIMB(p, i+3, (u64)carry);
+        carry >>= 64;
+    }
+}
+
+#else // 32-bit limbs
+
 //  p = a*b + p
 static void multiply(u32 p[16], const u32 a[8], const u32 b[8]){
    size_t i, j;
@@ -78,6 +186,74 @@ static void multiply(u32 p[16], const u32 a[8], const u32 b[8]){
     }
 }
 
+//  p = a^2
+// Products a[i]*a[j] and a[j]*a[i] are equal, so we compute 
+// only 28 cross products (i < j), double them with one shift
+// and add 8 squares a[i]^2, i.e. 36 u32 multiplications
+// instead of 64 in multiply().
+static void square(u32 p[16], const u32 a[8]){
+    size_t i, j;
+    u64 carry;
+
+    ZERO(i, p, 16);
+    // cross products
+    FOR (i, 0, 8) {
+        carry = 0;
+        FOR (j, i+1, 8) {
+            carry  += p[i+j] + (u64)a[i] * a[j];
+            p[i+j]  = (u32)carry;
+            carry >>= 32;
+        }
+        p[i+8] = (u32)carry;
+    }
+    // 2 * cross products
+    p[15] = p[14] >> 31;
+    for (i = 14; i > 0; i--) {
+        p[i] = (p[i] << 1) | (p[i-1] >> 31);
+    }
+    p[0] = 0;
+    // + squares
+    carry = 0;
+    FOR (i, 0, 8) {
+        u64 sq = (u64)a[i] * a[i];
+        carry  += (u64)p[2*i] + (u32)sq;
+        p[2*i]  = (u32)carry;
+        carry >>= 32;
+        carry  += (u64)p[2*i+1] + (u32)(sq >> 32);
+        p[2*i+1] = (u32)carry;
+        carry >>= 32;
+    }
+}
+
+//  p = s * L
+// L = 2^252 + L[0..3], so instead of 64 multiplications we
+// multiply only by 4 low words of L and add s << 252.
+static void multiply_l(u32 p[16], const u32 s[8]){
+    size_t i, j;
+    u64 carry;
+
+    ZERO(i, p, 16);
+    FOR (i, 0, 8) {
+        carry = 0;
+        FOR (j, 0, 4) {
+            carry  += p[i+j] + (u64)s[i] * L[j];
+            p[i+j]  = (u32)carry;
+            carry >>= 32;
+        }
+        p[i+4] = (u32)carry;
+    }
+    // + s * 2^252 (2^252 = 2^28 * 2^(7*32))
+    carry = 0;
+    FOR (i, 0, 9) {
+        u32 shifted = (i < 8 ? s[i] << 28 : 0) | (i > 0 ? s[i-1] >> 4 : 0);
+        carry  += (u64)p[i+7] + shifted;
+        p[i+7]  = (u32)carry;
+        carry >>= 32;
+    }
+}
+
+#endif // MODL_64BIT_FLAG
+
 static int is_above_l(const u32 x[8]){
    size_t i;
     // We work with L directly, in a 2's complement encoding
@@ -105,6 +281,54 @@ static void remove_l(u32 r[8], const u32 x[8]){
     }
 }
 
+#ifdef MODL_64BIT_FLAG
+// Full reduction modulo L (Barrett reduction), 64-bit limbs
+// Same algorithm as 32-bit version below, r = floor(2^512/L)
+// in 5x 64-bit limbs.
+void mod_l(u8 reduced[32], const u32 x[16]){
+    static const u64 r64[5] = {
+        0xed9ce5a30a2c131bULL, 0x2106215d086329a7ULL,
+        0xffffffffffffffebULL, 0xffffffffffffffffULL, 0xfULL,
+    };
+    u64 xr64[13] = {0};
+    u32 xr[8];
+    size_t i, j;
+
+    // xr = x * r
+    FOR (i, 0, 5) {
+        u128 carry = 0;
+        FOR (j, 0, 8) {
+            carry    += xr64[i+j] + (u128)r64[i] * LIMB(x, j);
+            xr64[i+j] = (u64)carry;
+            carry   >>= 64;
+        }
+        xr64[i+8] = (u64)carry;
+    }
+    // xr = floor(xr / 2^512) * L (only the first 256 bits)
+    ZERO(i, xr64, 4);
+    FOR (i, 0, 4) {
+        u128 carry = 0;
+        FOR (j, 0, 4-i) {
+            carry    += xr64[i+j] + (u128)xr64[i+8] * L64[j];
+            xr64[i+j] = (u64)carry;
+            carry   >>= 64;
+        }
+    }
+    // xr = x - xr
+    u128 carry = 1;
+    FOR (i, 0, 4) {
+        carry    += (u128)LIMB(x, i) + (u64)~xr64[i];
+        xr64[i]   = (u64)carry;
+        carry   >>= 64;
+    }
+    store64_words(xr, xr64, 4);
+    // Final reduction modulo L (conditional subtraction)
+    remove_l(xr, xr);
+    store32_le_buf(reduced, xr, 8);
+
+    WIPE_BUFFER(xr64); WIPE_BUFFER(xr);
+}
+#else
 // Full reduction modulo L (Barrett reduction)
 void mod_l(u8 reduced[32], const u32 x[16]){
    size_t i, j;
@@ -156,6 +380,7 @@ void mod_l(u8 reduced[32], const u32 x[16]){
 
     WIPE_BUFFER(xr);
 }
+#endif // MODL_64BIT_FLAG
 
 
 /********************* WARNING ********************************/
@@ -164,7 +389,6 @@ void mod_l(u8 reduced[32], const u32 x[16]){
 
 // MONTGOMERY implementation of modular inverse (mod l).
 // More efficient in some ways (). See modl.h
-#ifdef MONTGOMERY_MODL_INVERSE_FLAG
 
 static u32 load32_le(const u8 s[4])
 {
@@ -185,32 +409,39 @@ static void load32_le_buf (u32 *dst, const u8 *src, size_t size) {
 /// Scalar division ///
 ///////////////////////
 
-// Montgomery reduction.
-// Divides x by (2^256), and reduces the result modulo L
-//
-// Precondition:
-//   x < L * 2^256
-// Constants:
-//   r = 2^256                 (makes division by r trivial)
-//   k = (r * (1/r) - 1) // L  (1/r is computed modulo L, note that this is done by inverse modL)
-// Algorithm:
-//   s = (x * k) % r
-//   t = x + s*L      (t is always a multiple of r)
-//   u = (t/r) % L    (u is always below 2*L, conditional subtraction is enough)
-static void redc(u32 u[8], u32 x[16])
+// s = x * k (modulo 2^256), where
+// k = (r * (1/r) - 1) // L  (1/r is computed modulo L, note that this is done by inverse modL)
+// Note that pseudo code would look like this: (r * inv_mod_l(1,r) - 1) // L
+// where '//' denotes  floor division e.g. 4//3 = 1 
+// This is cheaper than the full multiplication.
+#ifdef MODL_64BIT_FLAG
+static void multiply_k_low(u32 s[8], const u32 x[8])
+{
+    static const u64 k64[4] = {
+        0xd2b51da312547e1bULL, 0xb1a206f2fdba84ffULL,
+        0x14e75438ffa36beaULL, 0x9db6c6f26fe91836ULL,
+    };
+    size_t idx, jdx;
+    ZERO(idx, s, 8);
+
+    FOR (idx, 0, 4) {
+        u128 carry = 0;
+        FOR (jdx, 0, 4-idx) {
+            carry  += LIMB(s, idx+jdx) + (u128)LIMB(x, idx) * k64[jdx];
+            SET_LIMB(s, idx+jdx, (u64)carry);
+            carry >>= 64;
+        }
+    }
+}
+#else
+static void multiply_k_low(u32 s[8], const u32 x[8])
 {
-    // k = (r * (1/r) - 1) // L  (1/r is computed modulo L, note that this is done by inverse modL)
-    // Note that pseudo code would look like this: (r * inv_mod_l(1,r) - 1) // L
-    // where '//' denotes  floor division e.g. 4//3 = 1 
     static const u32 k[8] = {
         0x12547e1b, 0xd2b51da3, 0xfdba84ff, 0xb1a206f2,
         0xffa36bea, 0x14e75438, 0x6fe91836, 0x9db6c6f2,
     };
-
-    // s = x * k (modulo 2^256)
-    // This is cheaper than the full multiplication.
-    u32 s[8] = {0};
     size_t idx;
+    ZERO(idx, s, 8);
     
     FOR (idx, 0, 8) {
         u64 carry = 0;
@@ -221,8 +452,26 @@ static void redc(u32 u[8], u32 x[16])
             carry >>= 32;
         }
     }
-    u32 t[16] = {0};
-    multiply(t, s, L);
+}
+#endif // MODL_64BIT_FLAG
+
+// Montgomery reduction.
+// Divides x by (2^256), and reduces the result modulo L
+//
+// Precondition:
+//   x < L * 2^256
+// Constants:
+//   r = 2^256                 (makes division by r trivial)
+//   k = (r * (1/r) - 1) // L  (1/r is computed modulo L, note that this is done by inverse modL)
+// Algorithm:
+//   s = (x * k) % r
+//   t = x + s*L      (t is always a multiple of r)
+//   u = (t/r) % L    (u is always below 2*L, conditional subtraction is enough)
+static void redc_scratch(u32 u[8], const u32 x[16], u32 s[8], u32 t[16])
+{
+    // s = x * k (modulo 2^256)
+    multiply_k_low(s, x);
+    multiply_l(t, s);
 
     // t = t + x
     size_t index;
@@ -237,7 +486,16 @@ static void redc(u32 u[8], u32 x[16])
     // Note that t / 2^256 is always below 2*L,
     // So a constant time conditional subtraction is enough
     remove_l(u, t+8);
+}
 
+// Temporary buffers s, t of redc_scratch are provided by caller,
+// so caller doing many reductions can wipe them only once
+// (see inverse_mod_l_chain), redc wipes them after every call.
+static void redc(u32 u[8], u32 x[16])
+{
+    u32 s[8];
+    u32 t[16];
+    redc_scratch(u, x, s, t);
     WIPE_BUFFER(s);
     WIPE_BUFFER(t);
 }
@@ -298,7 +556,7 @@ void crypto_x25519_inverse(u8 out[BYTES_ELEM_SIZE], const u8 in[BYTES_ELEM_SIZE]
     WIPE_BUFFER(m_scl);
     WIPE_BUFFER(product);  WIPE_BUFFER(m_inv);
 }
-#else //Barrett reduction
+
 /********************* WARNING ********************************/
 // Functional only on CPU with Little Endian architecture!
 // Feature for Big Endian architecture is not implemented (yet). 
@@ -332,4 +590,1038 @@ void inverse_mod_l(u8 out[BYTES_ELEM_SIZE], const u8 in[BYTES_ELEM_SIZE]){
     COPY(i ,out, (u8*) m_inv, BYTES_ELEM_SIZE);
     WIPE_BUFFER(m_inv);
 }
-#endif
\ No newline at end of file
+
+
+// Fixed addition chain for L - 2 (sliding window of width 4),
+// every step is (number of squarings, index of odd power x^(2i+1)).
+// Chain starts with x^1 and ends with the last multiplication,
+// it has 252 squarings and 27 multiplications (+ 8 operations 
+// for table of odd powers x^1, x^3, ..., x^15), instead of 
+// 253 squarings and 125 multiplications of square-and-multiply.
+// Chain was generated and checked by short python script
+// (pow(x, L-2, L)).
+static const u8 Lm2_chain[27][2] = {
+    {130, 2}, {6, 6}, {3, 3}, {5, 7}, {4, 4}, {4, 6}, {3, 3}, {4, 2}, {7, 5},
+    {4, 6}, {3, 3}, {5, 3}, {6, 6}, {3, 1}, {6, 5}, {10, 4}, {4, 1}, {5, 1},
+    {7, 6}, {6, 5}, {4, 4}, {3, 3}, {5, 5}, {3, 2}, {6, 7}, {3, 2}, {3, 1},
+};
+
+// Temporary space of Montgomery multiplication, it is wiped
+// only once at the end of inverse_mod_l_chain (crypto_wipe after
+// every multiplication would take more time than the reduction),
+// public functions get it from caller as ristretto255_mont_ws
+typedef ristretto255_mont_ws mont_scratch;
+
+// p = a * b / 2^256 (mod L)
+static void mont_mul(u32 p[8], const u32 a[8], const u32 b[8], mont_scratch* scratch){
+    size_t i;
+    ZERO(i, scratch->product, 16);
+    multiply(scratch->product, a, b);
+    redc_scratch(p, scratch->product, scratch->s, scratch->t);
+}
+
+// p = a^2 / 2^256 (mod L)
+static void mont_sqr(u32 p[8], const u32 a[8], mont_scratch* scratch){
+    square(scratch->product, a);
+    redc_scratch(p, scratch->product, scratch->s, scratch->t);
+}
+
+
+// m_inv = m_in^(L-2) in Montgomery form, i.e. for m_in = a*2^256
+// m_inv = a^-1 * 2^256 (mod L), see Lm2_chain
+// *** STACKSIZE: 8x u32[8] = 256B + 1x u32[8] + (4size_t) ***
+static void mont_inverse_chain(u32 m_inv[8], const u32 m_in[8], mont_scratch* scratch){
+    // odd powers x^1, x^3, ..., x^15 in Montgomery form
+    u32 odd_powers[8][8];
+    u32 m_sqr[8];
+    size_t i;
+    int k;
+
+    COPY(i, odd_powers[0], m_in, 8);
+    mont_sqr(m_sqr, odd_powers[0], scratch);
+    FOR (i, 1, 8) {
+        mont_mul(odd_powers[i], odd_powers[i-1], m_sqr, scratch);
+    }
+
+    COPY(i, m_inv, odd_powers[0], 8);
+    FOR (i, 0, 27) {
+        FOR (k, 0, Lm2_chain[i][0]) {
+            mont_sqr(m_inv, m_inv, scratch);
+        }
+        mont_mul(m_inv, m_inv, odd_powers[Lm2_chain[i][1]], scratch);
+    }
+
+    WIPE_BUFFER(odd_powers); WIPE_BUFFER(m_sqr);
+}
+
+// u = m / 2^256 (mod L), conversion out of Montgomery form
+static void mont_out(u32 u[8], const u32 m[8], mont_scratch* scratch){
+    size_t i;
+    COPY(i, scratch->product, m, 8);
+    ZERO(i, scratch->product + 8, 8);
+    redc_scratch(u, scratch->product, scratch->s, scratch->t);
+}
+
+
+/**
+  * @brief Modular inverse (mod L) by fixed addition chain
+  * @param[in]   -> in[32] scalar (does not have to be reduced)
+  * @param[out]  -> out[32] = in^(L-2) mod L
+**/
+// Same Montgomery arithmetic as crypto_x25519_inverse, but
+// exponentiation uses fixed addition chain (Lm2_chain) and 
+// dedicated squaring. Chain does not depend on input, so 
+// function runs in constant time. Inverse of 0 is 0.
+// *** STACKSIZE: 2x u32[8] + mont_scratch 160B + (288B + 4size_t) ***
+void inverse_mod_l_chain(u8 out[BYTES_ELEM_SIZE], const u8 in[BYTES_ELEM_SIZE]){
+    u32 m_scl[8];
+    u32 m_inv[8];
+    mont_scratch scratch;
+    size_t i;
+
+    // Convert the scalar in Montgomery form
+    // m_scl = scalar * 2^256 (modulo L)
+    {
+        u32 tmp[16];
+        ZERO(i, tmp, 8);
+        load32_le_buf(tmp+8, in, 8);
+        mod_l(out, tmp);
+        load32_le_buf(m_scl, out, 8);
+        WIPE_BUFFER(tmp);
+    }
+
+    mont_inverse_chain(m_inv, m_scl, &scratch);
+
+    // Convert the inverse *out* of Montgomery form
+    // scalar = m_inv / 2^256 (modulo L)
+    mont_out(m_inv, m_inv, &scratch);
+    store32_le_buf(out, m_inv, 8);
+
+    WIPE_BUFFER(m_scl); WIPE_BUFFER(m_inv);
+    crypto_wipe(&scratch, sizeof(scratch));
+}
+
+
+// 2^512 mod L, Montgomery product with R2 converts into Montgomery form
+static const u32 R2[8] = {
+    0x449c0f01, 0xa40611e3, 0x68859347, 0xd00e1ba7,
+    0x17f5be65, 0xceec73d2, 0x7c309a3d, 0x0399411b,
+};
+// 1 in Montgomery form (2^256 mod L)
+static const u32 R[8] = {
+    0x8d98951d, 0xd6ec3174, 0x737dcf70, 0xc6ef5bf4,
+    0xfffffffe, 0xffffffff, 0xffffffff, 0x0fffffff,
+};
+
+// m = in * 2^256 (mod L) (Montgomery form of in, computed as
+// Montgomery product of in and 2^512 mod L), zero (mod L) is
+// replaced by 1 in constant time, returns all-ones mask if in 
+// was zero (mod L), 0 otherwise
+static u32 mont_in_nonzero(u32 m[8], const u8 in[BYTES_ELEM_SIZE], mont_scratch* scratch){
+    u32 a[8];
+    u32 acc = 0;
+    u32 zero_mask;
+    size_t i;
+
+    load32_le_buf(a, in, 8);
+    mont_mul(m, a, R2, scratch);
+    FOR (i, 0, 8) {
+        acc |= m[i];
+    }
+    // acc == 0 -> (0 - 1) >> 32 = 0xffffffff, otherwise 0
+    zero_mask = (u32)(((u64)acc - 1) >> 32);
+    FOR (i, 0, 8) {
+        m[i] = (m[i] & ~zero_mask) | (R[i] & zero_mask);
+    }
+
+    WIPE_BUFFER(a);
+    return zero_mask;
+}
+
+
+/**
+  * @brief Modular inverse (mod L) of array of scalars
+  * @param[in]   -> in array of len scalars u8[32] (do not have to be reduced)
+  * @param[in]   -> len
+  * @param[out]  -> out array of len scalars u8[32], out[i] = in[i]^-1 mod L
+**/
+// Montgomery's trick: 
+// prefix products c_i = a_0 * ... * a_i, one inversion of c_(n-1),
+// and backwards a_i^-1 = c_i^-1 * c_(i-1), c_(i-1)^-1 = c_i^-1 * a_i.
+// So batch costs one inversion + 3(n-1) Montgomery multiplications
+// + conversions into/out of Montgomery form. Prefix products
+// are stored in out, so no additional memory is needed and 
+// Montgomery form of a_i is recomputed in backward pass.
+// Zero inputs are replaced by 1 (in constant time), so they do not
+// zero out whole product, and their output is set to 0 at the end,
+// which matches modl_l_inverse (inverse of 0 is 0).
+// Note that out and in must not overlap.
+// *** STACKSIZE: 3x u32[8] + mont_scratch 160B + (288B + 4size_t) ***
+void modl_l_inverse_batch(u8 out[][BYTES_ELEM_SIZE], const u8 in[][BYTES_ELEM_SIZE], size_t len){
+    u32 acc[8];
+    u32 m[8];
+    u32 prev[8];
+    mont_scratch scratch;
+    u32 zero_mask;
+    size_t i, j;
+
+    if (len == 0){
+      return;
+    }
+
+    // prefix products (Montgomery form) into out
+    mont_in_nonzero(acc, in[0], &scratch);
+    store32_le_buf(out[0], acc, 8);
+    FOR (i, 1, len) {
+        mont_in_nonzero(m, in[i], &scratch);
+        mont_mul(acc, acc, m, &scratch);
+        store32_le_buf(out[i], acc, 8);
+    }
+
+    // acc = (a_0 * ... * a_(n-1))^-1
+    mont_inverse_chain(acc, acc, &scratch);
+
+    for (i = len - 1; i > 0; i--) {
+        zero_mask = mont_in_nonzero(m, in[i], &scratch);
+        load32_le_buf(prev, out[i-1], 8);
+        // a_i^-1 = c_i^-1 * c_(i-1)
+        mont_mul(prev, acc, prev, &scratch);
+        // c_(i-1)^-1 = c_i^-1 * a_i
+        mont_mul(acc, acc, m, &scratch);
+        mont_out(prev, prev, &scratch);
+        FOR (j, 0, 8) {
+            prev[j] &= ~zero_mask;
+        }
+        store32_le_buf(out[i], prev, 8);
+    }
+    zero_mask = mont_in_nonzero(m, in[0], &scratch);
+    mont_out(acc, acc, &scratch);
+    FOR (j, 0, 8) {
+        acc[j] &= ~zero_mask;
+    }
+    store32_le_buf(out[0], acc, 8);
+
+    WIPE_BUFFER(acc); WIPE_BUFFER(m); WIPE_BUFFER(prev);
+    crypto_wipe(&scratch, sizeof(scratch));
+}
+
+
+///////////////////////////////
+/// Scalar arithmetic API   ///
+///////////////////////////////
+// Add/sub/neg are the same in normal and Montgomery form, so both
+// types share static helpers below. All functions run in constant
+// time.
+
+// r = a + b (mod L), a, b < L
+static void scalar_add(u32 r[8], const u32 a[8], const u32 b[8]){
+    u32 sum[8];
+    u64 carry = 0;
+    size_t i;
+    FOR (i, 0, 8) {
+        carry += (u64)a[i] + b[i];
+        sum[i] = (u32)carry;
+        carry >>= 32;
+    }
+    // a + b < 2*L < 2^256
+    remove_l(r, sum);
+    WIPE_BUFFER(sum);
+}
+
+// r = a - b (mod L) = a + (L - b) (mod L), a, b < L
+static void scalar_sub(u32 r[8], const u32 a[8], const u32 b[8]){
+    u32 diff[8];
+    // a + L + ~b + 1
+    u64 carry = 1;
+    size_t i;
+    FOR (i, 0, 8) {
+        carry += (u64)a[i] + L[i] + (~b[i] & 0xffffffff);
+        diff[i] = (u32)carry;
+        carry >>= 32;
+    }
+    // 0 < a + L - b < 2*L
+    remove_l(r, diff);
+    WIPE_BUFFER(diff);
+}
+
+
+/**
+  * @brief Decode canonical scalar
+  * @param[in]   -> in[32] little-endian bytes
+  * @param[out]  -> out ristretto255_scalar
+  * @return 0 on success, 1 if in is not canonical (in >= L)
+**/
+// Non-canonical input is reported, but out is reduced (mod L) 
+// anyway. Wide (64B) hashes should go through
+// ristretto255_scalar_from_wide_bytes.
+// *** STACKSIZE: 16x u32 = 64B + 32B + (mod_l 100B + 2size_t) ***
+int ristretto255_scalar_decode(ristretto255_scalar* out, const u8 in[BYTES_ELEM_SIZE]){
+    u32 wide[16];
+    u8 reduced[BYTES_ELEM_SIZE];
+    int is_above;
+    size_t i;
+
+    load32_le_buf(wide, in, 8);
+    ZERO(i, wide + 8, 8);
+    is_above = is_above_l(wide);
+    mod_l(reduced, wide);
+    load32_le_buf(out->v, reduced, 8);
+
+    WIPE_BUFFER(wide); WIPE_BUFFER(reduced);
+    #ifdef DEBUG_FLAG
+        if (is_above){
+            printf("ristretto255_scalar_decode: Non-canonical scalar!\n");
+        }
+    #endif
+    return is_above;
+}
+
+
+/**
+  * @brief Encode scalar into bytes
+  * @param[in]   -> a ristretto255_scalar
+  * @param[out]  -> out[32] little-endian bytes
+**/
+void ristretto255_scalar_encode(u8 out[BYTES_ELEM_SIZE], const ristretto255_scalar* a){
+    store32_le_buf(out, a->v, 8);
+}
+
+
+/**
+  * @brief Constant-time equality of scalars
+  * @param[in]   -> a, b ristretto255_scalar
+  * @return 1 if a == b, 0 otherwise
+**/
+int ristretto255_scalar_eq(const ristretto255_scalar* a, const ristretto255_scalar* b){
+    u32 diff = 0;
+    size_t i;
+    FOR (i, 0, 8) {
+        diff |= a->v[i] ^ b->v[i];
+    }
+    return (int)(1 & (((u64)diff - 1) >> 32));
+}
+
+
+/**
+  * @brief out = a + b (mod L)
+  * @param[in]   -> a, b ristretto255_scalar
+  * @param[out]  -> out ristretto255_scalar
+**/
+void ristretto255_scalar_add(ristretto255_scalar* out, const ristretto255_scalar* a, const ristretto255_scalar* b){
+    scalar_add(out->v, a->v, b->v);
+}
+
+
+/**
+  * @brief out = a - b (mod L)
+  * @param[in]   -> a, b ristretto255_scalar
+  * @param[out]  -> out ristretto255_scalar
+**/
+void ristretto255_scalar_sub(ristretto255_scalar* out, const ristretto255_scalar* a, const ristretto255_scalar* b){
+    scalar_sub(out->v, a->v, b->v);
+}
+
+
+/**
+  * @brief out = -a (mod L)
+  * @param[in]   -> a ristretto255_scalar
+  * @param[out]  -> out ristretto255_scalar
+**/
+void ristretto255_scalar_neg(ristretto255_scalar* out, const ristretto255_scalar* a){
+    static const u32 zero[8] = {0};
+    scalar_sub(out->v, zero, a->v);
+}
+
+
+/**
+  * @brief out = a * b (mod L)
+  * @param[in]   -> a, b ristretto255_scalar
+  * @param[out]  -> out ristretto255_scalar
+**/
+// Single multiplication, product is reduced by Barrett (mod_l),
+// for chains of multiplications use Montgomery form 
+// (ristretto255_scalar_mont_mul).
+// *** STACKSIZE: 16x u32 = 64B + 32B + (mod_l 100B + 2size_t) ***
+void ristretto255_scalar_mul(ristretto255_scalar* out, const ristretto255_scalar* a, const ristretto255_scalar* b){
+    u32 product[16] = {0};
+    u8 reduced[BYTES_ELEM_SIZE];
+
+    multiply(product, a->v, b->v);
+    mod_l(reduced, product);
+    load32_le_buf(out->v, reduced, 8);
+
+    WIPE_BUFFER(product); WIPE_BUFFER(reduced);
+}
+
+
+/**
+  * @brief out = a^2 (mod L)
+  * @param[in]   -> a ristretto255_scalar
+  * @param[out]  -> out ristretto255_scalar
+**/
+// *** STACKSIZE: 16x u32 = 64B + 32B + (mod_l 100B + 2size_t) ***
+void ristretto255_scalar_square(ristretto255_scalar* out, const ristretto255_scalar* a){
+    u32 product[16];
+    u8 reduced[BYTES_ELEM_SIZE];
+
+    square(product, a->v);
+    mod_l(reduced, product);
+    load32_le_buf(out->v, reduced, 8);
+
+    WIPE_BUFFER(product); WIPE_BUFFER(reduced);
+}
+
+
+/**
+  * @brief out = a^-1 (mod L), inverse of 0 is 0
+  * @param[in]   -> a ristretto255_scalar
+  * @param[out]  -> out ristretto255_scalar
+**/
+// Same addition chain as inverse_mod_l_chain.
+// *** STACKSIZE: 1x u32[8] + mont_scratch 160B + (288B + 4size_t) ***
+void ristretto255_scalar_invert(ristretto255_scalar* out, const ristretto255_scalar* a){
+    u32 m[8];
+    mont_scratch scratch;
+
+    mont_mul(m, a->v, R2, &scratch);
+    mont_inverse_chain(m, m, &scratch);
+    mont_out(out->v, m, &scratch);
+
+    WIPE_BUFFER(m);
+    crypto_wipe(&scratch, sizeof(scratch));
+}
+
+
+/**
+  * @brief Wipe caller-owned workspace of ristretto255_scalar_*_ws functions
+  * @param[in/out]   -> ws ristretto255_mont_ws
+**/
+// Chain of Montgomery operations (e.g. polynomial evaluation) shares
+// one workspace and wipes it once at the end, instead of wiping
+// 160B after every multiplication.
+void ristretto255_mont_ws_wipe(ristretto255_mont_ws* ws){
+    crypto_wipe(ws, sizeof(*ws));
+}
+
+
+/**
+  * @brief Convert scalar into Montgomery form, temporaries in workspace
+  * @param[in]   -> a ristretto255_scalar
+  * @param[in]   -> ws caller-owned workspace (not wiped)
+  * @param[out]  -> out ristretto255_scalar_mont
+**/
+// *** STACKSIZE: (4size_t) ***
+void ristretto255_scalar_to_mont_ws(ristretto255_scalar_mont* out, const ristretto255_scalar* a, ristretto255_mont_ws* ws){
+    mont_mul(out->v, a->v, R2, ws);
+}
+
+
+/**
+  * @brief Convert scalar into Montgomery form (out = a * 2^256 mod L)
+  * @param[in]   -> a ristretto255_scalar
+  * @param[out]  -> out ristretto255_scalar_mont
+**/
+// *** STACKSIZE: ristretto255_mont_ws 160B + (4size_t) ***
+void ristretto255_scalar_to_mont(ristretto255_scalar_mont* out, const ristretto255_scalar* a){
+    ristretto255_mont_ws ws;
+    ristretto255_scalar_to_mont_ws(out, a, &ws);
+    ristretto255_mont_ws_wipe(&ws);
+}
+
+
+/**
+  * @brief Convert scalar out of Montgomery form, temporaries in workspace
+  * @param[in]   -> a ristretto255_scalar_mont
+  * @param[in]   -> ws caller-owned workspace (not wiped)
+  * @param[out]  -> out ristretto255_scalar
+**/
+// *** STACKSIZE: (4size_t) ***
+void ristretto255_scalar_from_mont_ws(ristretto255_scalar* out, const ristretto255_scalar_mont* a, ristretto255_mont_ws* ws){
+    mont_out(out->v, a->v, ws);
+}
+
+
+/**
+  * @brief Convert scalar out of Montgomery form (out = a / 2^256 mod L)
+  * @param[in]   -> a ristretto255_scalar_mont
+  * @param[out]  -> out ristretto255_scalar
+**/
+// *** STACKSIZE: ristretto255_mont_ws 160B + (4size_t) ***
+void ristretto255_scalar_from_mont(ristretto255_scalar* out, const ristretto255_scalar_mont* a){
+    ristretto255_mont_ws ws;
+    ristretto255_scalar_from_mont_ws(out, a, &ws);
+    ristretto255_mont_ws_wipe(&ws);
+}
+
+
+/**
+  * @brief out = a + b (mod L) in Montgomery form
+  * @param[in]   -> a, b ristretto255_scalar_mont
+  * @param[out]  -> out ristretto255_scalar_mont
+**/
+void ristretto255_scalar_mont_add(ristretto255_scalar_mont* out, const ristretto255_scalar_mont* a, const ristretto255_scalar_mont* b){
+    scalar_add(out->v, a->v, b->v);
+}
+
+
+/**
+  * @brief out = a - b (mod L) in Montgomery form
+  * @param[in]   -> a, b ristretto255_scalar_mont
+  * @param[out]  -> out ristretto255_scalar_mont
+**/
+void ristretto255_scalar_mont_sub(ristretto255_scalar_mont* out, const ristretto255_scalar_mont* a, const ristretto255_scalar_mont* b){
+    scalar_sub(out->v, a->v, b->v);
+}
+
+
+/**
+  * @brief out = a * b (mod L) in Montgomery form
+  * @param[in]   -> a, b ristretto255_scalar_mont
+  * @param[out]  -> out ristretto255_scalar_mont
+**/
+// One multiplication + Montgomery reduction (redc), 
+// no conversion. Workspace is wiped after every call, for chains
+// of multiplications use ristretto255_scalar_mont_mul_ws.
+// *** STACKSIZE: ristretto255_mont_ws 160B + (4size_t) ***
+void ristretto255_scalar_mont_mul(ristretto255_scalar_mont* out, const ristretto255_scalar_mont* a, const ristretto255_scalar_mont* b){
+    ristretto255_mont_ws ws;
+    ristretto255_scalar_mont_mul_ws(out, a, b, &ws);
+    ristretto255_mont_ws_wipe(&ws);
+}
+
+
+/**
+  * @brief out = a * b (mod L) in Montgomery form, temporaries in workspace
+  * @param[in]   -> a, b ristretto255_scalar_mont
+  * @param[in]   -> ws caller-owned workspace (not wiped)
+  * @param[out]  -> out ristretto255_scalar_mont
+**/
+// *** STACKSIZE: (4size_t) ***
+void ristretto255_scalar_mont_mul_ws(ristretto255_scalar_mont* out, const ristretto255_scalar_mont* a, const ristretto255_scalar_mont* b, ristretto255_mont_ws* ws){
+    mont_mul(out->v, a->v, b->v, ws);
+}
+
+
+/**
+  * @brief out = a^2 (mod L) in Montgomery form
+  * @param[in]   -> a ristretto255_scalar_mont
+  * @param[out]  -> out ristretto255_scalar_mont
+**/
+// *** STACKSIZE: ristretto255_mont_ws 160B + (4size_t) ***
+void ristretto255_scalar_mont_square(ristretto255_scalar_mont* out, const ristretto255_scalar_mont* a){
+    ristretto255_mont_ws ws;
+    ristretto255_scalar_mont_square_ws(out, a, &ws);
+    ristretto255_mont_ws_wipe(&ws);
+}
+
+
+/**
+  * @brief out = a^2 (mod L) in Montgomery form, temporaries in workspace
+  * @param[in]   -> a ristretto255_scalar_mont
+  * @param[in]   -> ws caller-owned workspace (not wiped)
+  * @param[out]  -> out ristretto255_scalar_mont
+**/
+// *** STACKSIZE: (4size_t) ***
+void ristretto255_scalar_mont_square_ws(ristretto255_scalar_mont* out, const ristretto255_scalar_mont* a, ristretto255_mont_ws* ws){
+    mont_sqr(out->v, a->v, ws);
+}
+
+
+///////////////////////////////
+/// Wide reduction (64B)    ///
+///////////////////////////////
+// L = 2^252 + c, where c < 2^125 (4 words), so 2^252 = -c (mod L)
+// and x = x_hi * 2^252 + x_lo can be folded into x_lo - x_hi * c.
+// Three folds shrink 512-bit x to 386, 261 and finally < 2*L bits,
+// which costs 9*4 + 6*4 + 2*4 word multiplications instead of
+// 9*16 + 36 in mod_l (Barrett). To keep everything unsigned, we add
+// multiple of L bigger than x_hi * c in every fold.
+
+// 2^133 * L (> 2^385 > x_hi * c of 512-bit x)
+static const u32 L_2_133[13] = {
+    0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x9eba7da0, 0x024c634b, 0x5ef39acb, 0x9bdf3bd4,
+    0x00000002, 0x00000000, 0x00000000, 0x00000000, 0x00000002,
+};
+// 2^8 * L (> 2^259 > x_hi * c of 386-bit x)
+static const u32 L_2_8[9] = {
+    0xf5d3ed00, 0x12631a5c, 0xf79cd658, 0xdef9dea2, 0x00000014, 0x00000000, 0x00000000, 0x00000000,
+    0x00000010,
+};
+
+typedef struct wide_scratch {
+    u32 x[16];
+    u32 h[9];
+    u32 hc[13];
+} wide_scratch;
+
+// x = (x mod 2^252) + k - floor(x / 2^252) * c (in place), k is
+// multiple of L, so result is the same (mod L). Result is positive
+// and caller guarantees that it fits into out_len words.
+static void fold_l(u32* x, size_t x_len, size_t out_len, const u32* k, size_t k_len, wide_scratch* scratch){
+    size_t h_len = x_len - 7;
+    size_t i, j;
+    u64 carry;
+    // h = floor(x / 2^252)
+    FOR (i, 0, h_len) {
+        scratch->h[i] = (x[i+7] >> 28) | (i+8 < x_len ? x[i+8] << 4 : 0);
+    }
+    // hc = h * c, c is stored in L[0..3]
+    ZERO(i, scratch->hc, h_len + 4);
+    FOR (i, 0, h_len) {
+        carry = 0;
+        FOR (j, 0, 4) {
+            carry += scratch->hc[i+j] + (u64)scratch->h[i] * L[j];
+            scratch->hc[i+j] = (u32)carry;
+            carry >>= 32;
+        }
+        scratch->hc[i+4] = (u32)carry;
+    }
+    // x = (x mod 2^252) + k + ~hc + 1, computed modulo 2^(32*out_len),
+    // which is exact, since the result fits into out_len words
+    x[7] &= 0x0fffffff;
+    carry = 1;
+    FOR (i, 0, out_len) {
+        carry += (i < 8 ? (u64)x[i] : 0) + (i < k_len ? k[i] : 0)
+               + (~(i < h_len + 4 ? scratch->hc[i] : 0) & 0xffffffff);
+        x[i]   = (u32)carry;
+        carry >>= 32;
+    }
+}
+
+// r = scratch->x (mod L), x is 512-bit number (16 words)
+static void reduce_wide_words(u32 r[8], wide_scratch* scratch){
+    // x < 2^512  -> x < 2^386
+    fold_l(scratch->x, 16, 13, L_2_133, 13, scratch);
+    // x < 2^386  -> x < 2^261
+    fold_l(scratch->x, 13, 9, L_2_8, 9, scratch);
+    // x < 2^261  -> x < 2^252 + L < 2*L
+    fold_l(scratch->x, 9, 8, L, 8, scratch);
+    remove_l(r, scratch->x);
+}
+
+// r = in (mod L), in is 64B little-endian number
+static void reduce_wide(u32 r[8], const u8 in[HASH_BYTES_SIZE], wide_scratch* scratch){
+    load32_le_buf(scratch->x, in, 16);
+    reduce_wide_words(r, scratch);
+}
+
+
+/**
+  * @brief Reduce 64B hash (e.g. SHA-512 digest) into scalar
+  * @param[in]   -> in[64] little-endian bytes
+  * @param[out]  -> out ristretto255_scalar
+**/
+// Same result as mod_l, but input is taken directly as bytes
+// and reduction uses sparse structure of L (see fold_l).
+// Runs in constant time.
+// *** STACKSIZE: wide_scratch 152B + (4size_t) ***
+void ristretto255_scalar_from_wide_bytes(ristretto255_scalar* out, const u8 in[HASH_BYTES_SIZE]){
+    wide_scratch scratch;
+    reduce_wide(out->v, in, &scratch);
+    crypto_wipe(&scratch, sizeof(scratch));
+}
+
+
+
+
+///////////////////////////////
+/// Scalar vector routines  ///
+///////////////////////////////
+
+// Number of products accumulated before reduction in
+// ristretto255_scalar_inner_product, every product of reduced
+// scalars is < L^2 < 2^506, so accumulator (< L) + 32 products
+// still fits into 512 bits
+#define INNER_PRODUCT_LAZY_TERMS 32
+
+/**
+  * @brief Inner product of two scalar vectors
+  * @param[in]   -> a[len], b[len] ristretto255_scalar
+  * @param[in]   -> len
+  * @param[out]  -> out = sum a[i] * b[i] (mod L)
+**/
+// Products are summed in 512-bit accumulator without reduction,
+// wide reduction (reduce_wide_words) runs only once per 
+// INNER_PRODUCT_LAZY_TERMS products. Runs in constant time.
+// *** STACKSIZE: 16x u32 = 64B + wide_scratch 152B + (6size_t) ***
+void ristretto255_scalar_inner_product(ristretto255_scalar* out, const ristretto255_scalar a[], const ristretto255_scalar b[], size_t len){
+    u32 product[16];
+    wide_scratch scratch;
+    size_t i, j, terms = 0;
+    u64 carry;
+
+    ZERO(i, scratch.x, 16);
+    FOR (i, 0, len) {
+        ZERO(j, product, 16);
+        multiply(product, a[i].v, b[i].v);
+        carry = 0;
+        FOR (j, 0, 16) {
+            carry       += (u64)scratch.x[j] + product[j];
+            scratch.x[j] = (u32)carry;
+            carry      >>= 32;
+        }
+        if (++terms == INNER_PRODUCT_LAZY_TERMS) {
+            reduce_wide_words(product, &scratch);
+            COPY(j, scratch.x, product, 8);
+            ZERO(j, scratch.x + 8, 8);
+            terms = 0;
+        }
+    }
+    reduce_wide_words(out->v, &scratch);
+
+    WIPE_BUFFER(product);
+    crypto_wipe(&scratch, sizeof(scratch));
+}
+
+
+/**
+  * @brief Polynomial evaluation by Horner's rule
+  * @param[in]   -> coeffs[len] ristretto255_scalar, coeffs[0] is constant term
+  * @param[in]   -> len number of coefficients
+  * @param[in]   -> x ristretto255_scalar
+  * @param[out]  -> out = sum coeffs[i] * x^i (mod L), 0 if len == 0
+**/
+// Only x is converted into Montgomery form (x * 2^256), then
+// Montgomery product acc * (x * 2^256) / 2^256 = acc * x stays in
+// normal form, so every step costs one multiplication + redc and
+// coefficients need no conversion. Runs in constant time.
+// *** STACKSIZE: 2x u32[8] + mont_scratch 160B + (4size_t) ***
+void ristretto255_scalar_poly_eval(ristretto255_scalar* out, const ristretto255_scalar coeffs[], size_t len, const ristretto255_scalar* x){
+    u32 x_mont[8];
+    u32 acc[8];
+    mont_scratch scratch;
+    size_t i;
+
+    ZERO(i, acc, 8);
+    mont_mul(x_mont, x->v, R2, &scratch);
+    for (i = len; i > 0; i--) {
+        mont_mul(acc, acc, x_mont, &scratch);
+        scalar_add(acc, acc, coeffs[i-1].v);
+    }
+    COPY(i, out->v, acc, 8);
+
+    WIPE_BUFFER(x_mont); WIPE_BUFFER(acc);
+    crypto_wipe(&scratch, sizeof(scratch));
+}
+
+
+// d = x_i * prod_(j != i) (x_j - x_i) in Montgomery form,
+// Montgomery product with scalar in normal form keeps d in
+// Montgomery form
+static void lagrange_denominator(u32 d[8], const ristretto255_scalar x[], size_t len, size_t i, u32 diff[8], mont_scratch* scratch){
+    size_t j;
+    mont_mul(d, x[i].v, R2, scratch);
+    FOR (j, 0, len) {
+        if (j != i) {
+            scalar_sub(diff, x[j].v, x[i].v);
+            mont_mul(d, d, diff, scratch);
+        }
+    }
+}
+
+/**
+  * @brief Lagrange coefficients at zero
+  * @param[in]   -> x[len] ristretto255_scalar, distinct nonzero points
+  * @param[in]   -> len
+  * @param[out]  -> out[len], out[i] = prod_(j != i) x_j / (x_j - x_i) (mod L)
+  * @return 0 on success, 1 if some x is 0 or points are not distinct 
+**/
+// Coefficients for interpolation of f(0) from shares f(x_i) (e.g.
+// threshold signing), f(0) = sum out[i] * f(x_i), see
+// ristretto255_scalar_inner_product.
+// out[i] = (prod x_j) / d_i, d_i = x_i * prod_(j != i) (x_j - x_i).
+// All d_i are inverted at once by Montgomery's trick (see
+// modl_l_inverse_batch), prefix products are stored in out and
+// d_i is recomputed in backward pass instead of keeping another
+// array, so cost is 2*len^2 Montgomery multiplications + one inversion.
+// On error out is set to zeros. Note that out and x must not overlap.
+// *** STACKSIZE: 5x u32[8] + mont_scratch 160B + (288B + 4size_t) ***
+int ristretto255_scalar_lagrange_at_zero(ristretto255_scalar out[], const ristretto255_scalar x[], size_t len){
+    u32 num[8];
+    u32 acc[8];
+    u32 d[8];
+    u32 diff[8];
+    u32 is_zero = 0;
+    mont_scratch scratch;
+    size_t i, j;
+
+    if (len == 0){
+      return 0;
+    }
+
+    // num = prod x_j, starting with 2^512 (mod L) keeps product
+    // in Montgomery form, then it is converted into normal form
+    COPY(i, num, R2, 8);
+    FOR (i, 0, len) {
+        mont_mul(num, num, x[i].v, &scratch);
+    }
+    mont_out(num, num, &scratch);
+
+    // prefix products of d_i (Montgomery form) into out
+    FOR (i, 0, len) {
+        lagrange_denominator(d, x, len, i, diff, &scratch);
+        if (i == 0) {
+            COPY(j, acc, d, 8);
+        } else {
+            mont_mul(acc, acc, d, &scratch);
+        }
+        COPY(j, out[i].v, acc, 8);
+    }
+    FOR (i, 0, 8) {
+        is_zero |= acc[i];
+    }
+    if (is_zero == 0){
+        FOR (i, 0, len) {
+            ZERO(j, out[i].v, 8);
+        }
+        WIPE_BUFFER(num); WIPE_BUFFER(acc); WIPE_BUFFER(d); WIPE_BUFFER(diff);
+        crypto_wipe(&scratch, sizeof(scratch));
+        #ifdef DEBUG_FLAG
+            printf("ristretto255_scalar_lagrange_at_zero: Zero or duplicate point!\n");
+        #endif
+        return 1;
+    }
+
+    // acc = (d_0 * ... * d_(n-1))^-1
+    mont_inverse_chain(acc, acc, &scratch);
+
+    for (i = len - 1; i > 0; i--) {
+        lagrange_denominator(d, x, len, i, diff, &scratch);
+        // d_i^-1 = c_i^-1 * c_(i-1), out[i] = num * d_i^-1
+        mont_mul(diff, acc, out[i-1].v, &scratch);
+        mont_mul(out[i].v, num, diff, &scratch);
+        // c_(i-1)^-1 = c_i^-1 * d_i
+        mont_mul(acc, acc, d, &scratch);
+    }
+    mont_mul(out[0].v, num, acc, &scratch);
+
+    WIPE_BUFFER(num); WIPE_BUFFER(acc); WIPE_BUFFER(d); WIPE_BUFFER(diff);
+    crypto_wipe(&scratch, sizeof(scratch));
+    return 0;
+}
+
+
+/////////////////////////////////
+/// Multi-lane scalar kernels ///
+/////////////////////////////////
+// Same arithmetic as above, but RISTRETTO255_SCALAR_LANES
+// independent scalars are processed at once. Words are stored
+// limb-major (x[limb][lane]), so every innermost loop runs over
+// lanes with the same operation and no data-dependent branch,
+// which compiler turns into vector instructions (e.g. gcc -O3
+// -mavx2: 4 lanes of 32x32->64-bit multiplication per instruction,
+// -mavx512f: 8 lanes). There are no intrinsics, so the same code
+// runs on MCU (as plain loops). Results are identical to 
+// single-lane functions.
+
+#define LANES RISTRETTO255_SCALAR_LANES
+
+typedef struct lanes_scratch {
+    u32 a[8][LANES];
+    u32 b[8][LANES];
+    u32 x[16][LANES];
+    u32 h[9][LANES];
+    u32 hc[13][LANES];
+    u64 carry[LANES];
+} lanes_scratch;
+
+// x = a * b (all lanes)
+static void lanes_multiply(lanes_scratch* s){
+    size_t i, j, l;
+    FOR (i, 0, 16) {
+        ZERO(l, s->x[i], LANES);
+    }
+    FOR (i, 0, 8) {
+        ZERO(l, s->carry, LANES);
+        FOR (j, 0, 8) {
+            FOR (l, 0, LANES) {
+                s->carry[l]  += (u64)s->x[i+j][l] + (u64)s->a[i][l] * s->b[j][l];
+                s->x[i+j][l]  = (u32)s->carry[l];
+                s->carry[l] >>= 32;
+            }
+        }
+        FOR (l, 0, LANES) {
+            s->x[i+8][l] = (u32)s->carry[l];
+        }
+    }
+}
+
+// Lane version of fold_l (x_len, out_len and k are the same
+// for all lanes)
+static void lanes_fold_l(lanes_scratch* s, size_t x_len, size_t out_len, const u32* k, size_t k_len){
+    size_t h_len = x_len - 7;
+    size_t i, j, l;
+    FOR (i, 0, h_len) {
+        FOR (l, 0, LANES) {
+            s->h[i][l] = (s->x[i+7][l] >> 28) | (i+8 < x_len ? s->x[i+8][l] << 4 : 0);
+        }
+    }
+    FOR (i, 0, h_len + 4) {
+        ZERO(l, s->hc[i], LANES);
+    }
+    FOR (i, 0, h_len) {
+        ZERO(l, s->carry, LANES);
+        FOR (j, 0, 4) {
+            FOR (l, 0, LANES) {
+                s->carry[l]  += (u64)s->hc[i+j][l] + (u64)s->h[i][l] * L[j];
+                s->hc[i+j][l] = (u32)s->carry[l];
+                s->carry[l] >>= 32;
+            }
+        }
+        FOR (l, 0, LANES) {
+            s->hc[i+4][l] = (u32)s->carry[l];
+        }
+    }
+    FOR (l, 0, LANES) {
+        s->x[7][l] &= 0x0fffffff;
+        s->carry[l] = 1;
+    }
+    FOR (i, 0, out_len) {
+        FOR (l, 0, LANES) {
+            s->carry[l] += (i < 8 ? (u64)s->x[i][l] : 0) + (i < k_len ? k[i] : 0)
+                         + (~(i < h_len + 4 ? s->hc[i][l] : 0) & 0xffffffff);
+            s->x[i][l]   = (u32)s->carry[l];
+            s->carry[l] >>= 32;
+        }
+    }
+}
+
+// a = x - L if x >= L, x (first 8 words) < 2*L (lane version of remove_l)
+static void lanes_remove_l(lanes_scratch* s){
+    size_t i, l;
+    FOR (l, 0, LANES) {
+        s->carry[l] = 1;
+    }
+    FOR (i, 0, 8) {
+        FOR (l, 0, LANES) {
+            s->carry[l]  += (u64)s->x[i][l] + (~L[i] & 0xffffffff);
+            s->carry[l] >>= 32;
+        }
+    }
+    // h[0] = all-ones mask in lanes, where x >= L (carry == 1),
+    // carry stays as +1 of 2's complement -L
+    FOR (l, 0, LANES) {
+        s->h[0][l] = ~(u32)s->carry[l] + 1;
+    }
+    FOR (i, 0, 8) {
+        FOR (l, 0, LANES) {
+            s->carry[l]  += (u64)s->x[i][l] + (~L[i] & s->h[0][l]);
+            s->a[i][l]    = (u32)s->carry[l];
+            s->carry[l] >>= 32;
+        }
+    }
+}
+
+// a = x (mod L), x is 512-bit (lane version of reduce_wide_words)
+static void lanes_reduce_wide(lanes_scratch* s){
+    lanes_fold_l(s, 16, 13, L_2_133, 13);
+    lanes_fold_l(s, 13, 9, L_2_8, 9);
+    lanes_fold_l(s, 9, 8, L, 8);
+    lanes_remove_l(s);
+}
+
+// Transpose up to LANES scalars into rows (limb-major),
+// unused lanes are set to 0
+static void lanes_load(u32 rows[8][LANES], const ristretto255_scalar in[], size_t n){
+    size_t i, l;
+    FOR (i, 0, 8) {
+        FOR (l, 0, LANES) {
+            rows[i][l] = l < n ? in[l].v[i] : 0;
+        }
+    }
+}
+
+static void lanes_store(ristretto255_scalar out[], const u32 rows[8][LANES], size_t n){
+    size_t i, l;
+    FOR (l, 0, n) {
+        FOR (i, 0, 8) {
+            out[l].v[i] = rows[i][l];
+        }
+    }
+}
+
+
+/**
+  * @brief out[i] = a[i] * b[i] (mod L) for array of scalars
+  * @param[in]   -> a[len], b[len] ristretto255_scalar
+  * @param[in]   -> len
+  * @param[out]  -> out[len] ristretto255_scalar
+**/
+// Multi-lane version of ristretto255_scalar_mul, 
+// RISTRETTO255_SCALAR_LANES products at once, product is reduced
+// by lane version of sparse-L wide reduction. out can be the
+// same array as a or b.
+// *** STACKSIZE: lanes_scratch (54x LANES x u32 + LANES x u64) + (6size_t) ***
+void ristretto255_scalar_mul_batch(ristretto255_scalar out[], const ristretto255_scalar a[], const ristretto255_scalar b[], size_t len){
+    lanes_scratch scratch;
+    size_t i, n;
+    for (i = 0; i < len; i += n) {
+        n = len - i < LANES ? len - i : LANES;
+        lanes_load(scratch.a, a + i, n);
+        lanes_load(scratch.b, b + i, n);
+        lanes_multiply(&scratch);
+        lanes_reduce_wide(&scratch);
+        lanes_store(out + i, scratch.a, n);
+    }
+    crypto_wipe(&scratch, sizeof(scratch));
+}
+
+
+/**
+  * @brief out[i] = a[i] + b[i] (mod L) for array of scalars
+  * @param[in]   -> a[len], b[len] ristretto255_scalar
+  * @param[in]   -> len
+  * @param[out]  -> out[len] ristretto255_scalar
+**/
+// Multi-lane version of ristretto255_scalar_add, out can be 
+// the same array as a or b.
+// *** STACKSIZE: lanes_scratch (54x LANES x u32 + LANES x u64) + (7size_t) ***
+void ristretto255_scalar_add_batch(ristretto255_scalar out[], const ristretto255_scalar a[], const ristretto255_scalar b[], size_t len){
+    lanes_scratch scratch;
+    size_t i, j, l, n;
+    for (i = 0; i < len; i += n) {
+        n = len - i < LANES ? len - i : LANES;
+        lanes_load(scratch.a, a + i, n);
+        lanes_load(scratch.b, b + i, n);
+        ZERO(l, scratch.carry, LANES);
+        FOR (j, 0, 8) {
+            FOR (l, 0, LANES) {
+                scratch.carry[l]  += (u64)scratch.a[j][l] + scratch.b[j][l];
+                scratch.x[j][l]    = (u32)scratch.carry[l];
+                scratch.carry[l] >>= 32;
+            }
+        }
+        // a + b < 2*L < 2^256
+        lanes_remove_l(&scratch);
+        lanes_store(out + i, scratch.a, n);
+    }
+    crypto_wipe(&scratch, sizeof(scratch));
+}
+
+
+/**
+  * @brief Reduce array of 64B hashes into scalars
+  * @param[in]   -> in[len][64] little-endian bytes
+  * @param[in]   -> len number of hashes
+  * @param[out]  -> out[len] ristretto255_scalar
+**/
+// Every out[i] is the same as ristretto255_scalar_from_wide_bytes
+// of in[i], RISTRETTO255_SCALAR_LANES hashes are reduced at once.
+// *** STACKSIZE: lanes_scratch (54x LANES x u32 + LANES x u64) + (7size_t) ***
+void ristretto255_scalar_from_wide_bytes_batch(ristretto255_scalar out[], const u8 in[][HASH_BYTES_SIZE], size_t len){
+    lanes_scratch scratch;
+    size_t i, j, l, n;
+    for (i = 0; i < len; i += n) {
+        n = len - i < LANES ? len - i : LANES;
+        FOR (j, 0, 16) {
+            FOR (l, 0, LANES) {
+                scratch.x[j][l] = l < n ? load32_le(in[i+l] + 4*j) : 0;
+            }
+        }
+        lanes_reduce_wide(&scratch);
+        lanes_store(out + i, scratch.a, n);
+    }
+    crypto_wipe(&scratch, sizeof(scratch));
+}
+
+#undef LANES
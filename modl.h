@@ -51,13 +51,69 @@ void mod_l(u8 reduced[BYTES_ELEM_SIZE], const u32 x[16]);
 	* Barrett’s reduction is applicable when many reductions
 	* are performed with a single modulus."
 	* (https://eprint.iacr.org/2014/040.pdf).
+	*
+	* Third option, inverse_mod_l_chain, is Montgomery’s version
+	* with fixed addition chain for L-2 and dedicated squaring, it is
+	* selected by CHAIN_MODL_INVERSE_FLAG. All three functions are
+	* always compiled (so they can be benchmarked against each other),
+	* flags only select which one is used as modl_l_inverse.
 **/
 
-#ifdef MONTGOMERY_MODL_INVERSE_FLAG
-	void crypto_x25519_inverse(u8 out[BYTES_ELEM_SIZE], const u8 in[BYTES_ELEM_SIZE]);
+void crypto_x25519_inverse(u8 out[BYTES_ELEM_SIZE], const u8 in[BYTES_ELEM_SIZE]);
+void inverse_mod_l(u8 out[BYTES_ELEM_SIZE], const u8 in[BYTES_ELEM_SIZE]);
+void inverse_mod_l_chain(u8 out[BYTES_ELEM_SIZE], const u8 in[BYTES_ELEM_SIZE]);
+void modl_l_inverse_batch(u8 out[][BYTES_ELEM_SIZE], const u8 in[][BYTES_ELEM_SIZE], size_t len);
+
+// Scalar arithmetic modulo L, see ristretto255_scalar in helpers.h
+int ristretto255_scalar_decode(ristretto255_scalar* out, const u8 in[BYTES_ELEM_SIZE]);
+void ristretto255_scalar_from_wide_bytes(ristretto255_scalar* out, const u8 in[HASH_BYTES_SIZE]);
+void ristretto255_scalar_encode(u8 out[BYTES_ELEM_SIZE], const ristretto255_scalar* a);
+int ristretto255_scalar_eq(const ristretto255_scalar* a, const ristretto255_scalar* b);
+void ristretto255_scalar_add(ristretto255_scalar* out, const ristretto255_scalar* a, const ristretto255_scalar* b);
+void ristretto255_scalar_sub(ristretto255_scalar* out, const ristretto255_scalar* a, const ristretto255_scalar* b);
+void ristretto255_scalar_neg(ristretto255_scalar* out, const ristretto255_scalar* a);
+void ristretto255_scalar_mul(ristretto255_scalar* out, const ristretto255_scalar* a, const ristretto255_scalar* b);
+void ristretto255_scalar_square(ristretto255_scalar* out, const ristretto255_scalar* a);
+void ristretto255_scalar_invert(ristretto255_scalar* out, const ristretto255_scalar* a);
+void ristretto255_scalar_to_mont(ristretto255_scalar_mont* out, const ristretto255_scalar* a);
+void ristretto255_scalar_from_mont(ristretto255_scalar* out, const ristretto255_scalar_mont* a);
+void ristretto255_scalar_mont_add(ristretto255_scalar_mont* out, const ristretto255_scalar_mont* a, const ristretto255_scalar_mont* b);
+void ristretto255_scalar_mont_sub(ristretto255_scalar_mont* out, const ristretto255_scalar_mont* a, const ristretto255_scalar_mont* b);
+void ristretto255_scalar_mont_mul(ristretto255_scalar_mont* out, const ristretto255_scalar_mont* a, const ristretto255_scalar_mont* b);
+void ristretto255_scalar_mont_square(ristretto255_scalar_mont* out, const ristretto255_scalar_mont* a);
+void ristretto255_mont_ws_wipe(ristretto255_mont_ws* ws);
+void ristretto255_scalar_to_mont_ws(ristretto255_scalar_mont* out, const ristretto255_scalar* a, ristretto255_mont_ws* ws);
+void ristretto255_scalar_from_mont_ws(ristretto255_scalar* out, const ristretto255_scalar_mont* a, ristretto255_mont_ws* ws);
+void ristretto255_scalar_mont_mul_ws(ristretto255_scalar_mont* out, const ristretto255_scalar_mont* a, const ristretto255_scalar_mont* b, ristretto255_mont_ws* ws);
+void ristretto255_scalar_mont_square_ws(ristretto255_scalar_mont* out, const ristretto255_scalar_mont* a, ristretto255_mont_ws* ws);
+
+// Scalar vector routines (inner product, polynomial evaluation,
+// Lagrange coefficients), see modl.c
+void ristretto255_scalar_inner_product(ristretto255_scalar* out, const ristretto255_scalar a[], const ristretto255_scalar b[], size_t len);
+void ristretto255_scalar_poly_eval(ristretto255_scalar* out, const ristretto255_scalar coeffs[], size_t len, const ristretto255_scalar* x);
+int ristretto255_scalar_lagrange_at_zero(ristretto255_scalar out[], const ristretto255_scalar x[], size_t len);
+
+// Number of lanes of multi-lane scalar kernels (*_batch functions
+// below), 4 fits AVX2 (4x 64-bit products per instruction), 8 fits
+// AVX-512. Stack usage of kernels grows linearly with lanes,
+// so LOW_STACK_FLAG profile uses only 1 lane.
+#ifndef RISTRETTO255_SCALAR_LANES
+#ifdef LOW_STACK_FLAG
+#define RISTRETTO255_SCALAR_LANES 1
+#else
+#define RISTRETTO255_SCALAR_LANES 4
+#endif
+#endif
+
+void ristretto255_scalar_mul_batch(ristretto255_scalar out[], const ristretto255_scalar a[], const ristretto255_scalar b[], size_t len);
+void ristretto255_scalar_add_batch(ristretto255_scalar out[], const ristretto255_scalar a[], const ristretto255_scalar b[], size_t len);
+void ristretto255_scalar_from_wide_bytes_batch(ristretto255_scalar out[], const u8 in[][HASH_BYTES_SIZE], size_t len);
+
+#if defined(CHAIN_MODL_INVERSE_FLAG)
+	#define modl_l_inverse inverse_mod_l_chain
+#elif defined(MONTGOMERY_MODL_INVERSE_FLAG)
 	#define modl_l_inverse crypto_x25519_inverse
 #else
-	void inverse_mod_l(u8 out[BYTES_ELEM_SIZE], const u8 in[BYTES_ELEM_SIZE]);
 	#define modl_l_inverse inverse_mod_l
 #endif
 
@@ -170,6 +170,18 @@ static void wipe_ristretto255_point(ristretto255_point* ristretto_in){
 #define unpack25519 unpack
 
 
+/**
+  * @brief Wipe caller-owned workspace of ristretto255_*_ws functions
+  * @param[in/out]   -> ws ristretto255_ws
+**/
+// Functions with _ws suffix keep their temporaries in ws and never
+// wipe them, so caller decides when (e.g. after whole protocol 
+// step of many operations) all secrets are wiped at once.
+void ristretto255_ws_wipe(ristretto255_ws* ws){
+  crypto_wipe(ws, sizeof(*ws));
+}
+
+
 static void fe25519_reduce_emil(field_elem in){
   // this should reduce input that is in modulo 2P repr.
   // into modulo P repr.
@@ -267,12 +279,14 @@ void fabsolute(field_elem out, field_elem in){
 // largely inspired by Cyclone's curve25519Sqrt:
 // https://github.com/Oryx-Embedded/CycloneCRYPTO/blob/master/ecc/curve25519.c#L430
 // Logic Inspired by: https://ristretto.group/formulas/invsqrt.html
-// *** STACKSIZE: 196B + 5size_t ***
-static int inv_sqrt(field_elem out,const field_elem a, const field_elem b){
+// Temporaries c, v are taken from caller slots tmp[2] and they
+// are not wiped here (caller wipes all slots at once).
+// *** STACKSIZE: 2x field_elem slots + 132B + 5size_t ***
+static int inv_sqrt(field_elem out,const field_elem a, const field_elem b, field_elem* tmp){
    int correct_sign_sqrt;
    int flipped_sign_sqrt;
    int flipped_sign_sqrt_i;
-   field_elem c; field_elem v;
+   u32 *c = tmp[0], *v = tmp[1];
 
    // Compute the candidate root (A / B)^((p + 3) / 8). This can be
    // done with the following trick, using a single modular powering 
@@ -363,11 +377,62 @@ static int inv_sqrt(field_elem out,const field_elem a, const field_elem b){
    swap25519(out, v, is_neg(out)); 
    #endif  
 
-   WIPE_BUFFER(c); WIPE_BUFFER(v);
    return correct_sign_sqrt | flipped_sign_sqrt;
 }
 
 
+/**
+  * @brief Multiplicative inverse of field_elem
+  * @param[in]   -> a
+  * @param[out]  -> out = a^-1 (out = 0, if a = 0)
+**/
+// Since GF(p) is a prime field, we use Fermat's little theorem
+// and compute out = a^(p-2) = a^(2^255 - 21).
+// Addition chain is the same as the one used in inv_sqrt up to
+// a^(2^250 - 1), logic inspired by Cyclone's curve25519Inv:
+// https://github.com/Oryx-Embedded/CycloneCRYPTO/blob/master/ecc/curve25519.c
+// Note that finv is expensive (~254 squarings), so whenever
+// you need to invert more elements use Montgomery's trick
+// (see ristretto255_batch_normalize below).
+// *** STACKSIZE: 2x field_elem = 196B + 5size_t ***
+static void finv(field_elem out, const field_elem a){
+   field_elem u, v;
+
+   pow2(u, a);
+   fmul(u, u, a);                         //A^(2^2 - 1)
+   pow2(u, u);
+   fmul(v, u, a);                         //A^(2^3 - 1)
+   pow_xtimes(u, v, 3);
+   fmul(u, u, v);                         //A^(2^6 - 1)
+   pow2(u, u);
+   fmul(v, u, a);                         //A^(2^7 - 1)
+   pow_xtimes(u, v, 7);
+   fmul(u, u, v);                         //A^(2^14 - 1)
+   pow2(u, u);
+   fmul(v, u, a);                         //A^(2^15 - 1)
+   pow_xtimes(u, v, 15);
+   fmul(u, u, v);                         //A^(2^30 - 1)
+   pow2(u, u);
+   fmul(v, u, a);                         //A^(2^31 - 1)
+   pow_xtimes(u, v, 31);
+   fmul(v, u, v);                         //A^(2^62 - 1)
+   pow_xtimes(u, v, 62);
+   fmul(u, u, v);                         //A^(2^124 - 1)
+   pow2(u, u);
+   fmul(v, u, a);                         //A^(2^125 - 1)
+   pow_xtimes(u, v, 125);
+   fmul(u, u, v);                         //A^(2^250 - 1)
+   pow_xtimes(u, u, 2);
+   fmul(u, u, a);                         //A^(2^252 - 3)
+   pow_xtimes(u, u, 2);
+   fmul(u, u, a);                         //A^(2^254 - 11)
+   pow2(u, u);
+   fmul(out, u, a);                       //A^(2^255 - 21)
+
+   WIPE_BUFFER(u); WIPE_BUFFER(v);
+}
+
+
 /**
   * @brief Maps field_elem into ristretto255_point
   * @param[in]   -> t
@@ -387,9 +452,11 @@ static int inv_sqrt(field_elem out,const field_elem a, const field_elem b){
 // every line with draft specification.
 // DRAFT from 2023-09-18:
 // https://datatracker.ietf.org/doc/draft-irtf-cfrg-ristretto255-decaf448/
-// *** STACKSIZE: 356B + 5size_t + 2x int ***
-static void MAP(ristretto255_point* ristretto_out, const field_elem t){ 
-    field_elem tmp1, tmp2, tmp3, tmp4, tmp5;
+// Temporaries are taken from caller slots tmp[7] (5 + 2 for
+// inv_sqrt) and they are not wiped here.
+// *** STACKSIZE: 7x field_elem slots + 132B + 5size_t + 2x int ***
+static void MAP(ristretto255_point* ristretto_out, const field_elem t, field_elem* tmp){ 
+    u32 *tmp1 = tmp[0], *tmp2 = tmp[1], *tmp3 = tmp[2], *tmp4 = tmp[3], *tmp5 = tmp[4];
     int was_square, wasnt_square;
 
     #define _r tmp1
@@ -412,7 +479,7 @@ static void MAP(ristretto255_point* ristretto_out, const field_elem t){
     
     #define s tmp4
     #define s_prime tmp2
-    was_square = inv_sqrt(s,out,v);       //(was_square, s) = SQRT_RATIO_M1(u, v)
+    was_square = inv_sqrt(s,out,v,tmp+5); //(was_square, s) = SQRT_RATIO_M1(u, v)
 
     // note: we used swap25519 instead of fselect so our logic
     // is little bit different here
@@ -450,9 +517,6 @@ static void MAP(ristretto255_point* ristretto_out, const field_elem t){
     fmul(ristretto_out->y,w2,w1);         // w2*w1         
     fmul(ristretto_out->z,w1,w3);         // w1*w3 
     fmul(ristretto_out->t,w0,w2);         // w0*w2
-
-    WIPE_BUFFER(ss); WIPE_BUFFER(w2); WIPE_BUFFER(w0);
-    WIPE_BUFFER(w1); WIPE_BUFFER(w3);
 }
 
 
@@ -474,9 +538,11 @@ static void MAP(ristretto255_point* ristretto_out, const field_elem t){
 
 // Note that we redefined temporary variables multiple times
 // just to make code more readible.
-// *** STACKSIZE: 292B+ 4size_t ***
-void ristretto255_point_addition(ristretto255_point* r,const ristretto255_point* p,const ristretto255_point* q){
-    field_elem temp_1,temp_2,temp_3, temp_4, temp_5;
+// Temporaries are taken from caller slots tmp[5] and they are not
+// wiped here, see ristretto255_point_addition(_ws) below.
+// *** STACKSIZE: 5x field_elem slots + 132B + 4size_t ***
+static void point_addition_slots(ristretto255_point* r,const ristretto255_point* p,const ristretto255_point* q, field_elem* tmp){
+    u32 *temp_1 = tmp[0], *temp_2 = tmp[1], *temp_3 = tmp[2], *temp_4 = tmp[3], *temp_5 = tmp[4];
 
     #define a temp_1
     #define _t temp_2
@@ -516,9 +582,24 @@ void ristretto255_point_addition(ristretto255_point* r,const ristretto255_point*
     fe25519_reduce_emil(r->y);
     fe25519_reduce_emil(r->z);
     fe25519_reduce_emil(r->t);
+}
+
+// *** STACKSIZE: 5x field_elem = 160B + (132B + 4size_t) ***
+void ristretto255_point_addition(ristretto255_point* r,const ristretto255_point* p,const ristretto255_point* q){
+    field_elem tmp[5];
+    point_addition_slots(r, p, q, tmp);
+    WIPE_BUFFER(tmp);
+}
 
-    WIPE_BUFFER(d); WIPE_BUFFER(h); WIPE_BUFFER(g);
-    WIPE_BUFFER(f); WIPE_BUFFER(e);
+/**
+  * @brief Add two ristretto255_point points, temporaries in workspace
+  * @param[in]   -> p, q ristretto255_point
+  * @param[in]   -> ws caller-owned workspace (not wiped)
+  * @param[out]  -> r ristretto255_point
+**/
+// *** STACKSIZE: (132B + 4size_t) ***
+void ristretto255_point_addition_ws(ristretto255_point* r,const ristretto255_point* p,const ristretto255_point* q, ristretto255_ws* ws){
+    point_addition_slots(r, p, q, ws->fe);
 }
 
 
@@ -555,14 +636,17 @@ static void cswap(ristretto255_point* p, ristretto255_point* q,u8 b){
 // every line with draft specification.
 // DRAFT from 2023-09-18:
 // https://datatracker.ietf.org/doc/draft-irtf-cfrg-ristretto255-decaf448/
-// *** STACKSIZE: 420B + 5size_t + 3int ***
-int ristretto255_decode(ristretto255_point *ristretto_out, const u8 bytes_in[BYTES_ELEM_SIZE]){
+// Temporaries are taken from caller slots tmp[8] (6 + 2 for
+// inv_sqrt, checked_bytes share slot with inv_sqrt) and they are
+// not wiped here, see ristretto255_decode(_ws) below.
+// *** STACKSIZE: 8x field_elem slots + 132B + 5size_t + 3int ***
+static int decode_slots(ristretto255_point *ristretto_out, const u8 bytes_in[BYTES_ELEM_SIZE], field_elem* tmp){
   
   int was_square, is_canonical, is_negative;
 
-  field_elem temp1,temp2,temp3,temp4,temp5,temp6;
+  u32 *temp1 = tmp[0], *temp2 = tmp[1], *temp3 = tmp[2], *temp4 = tmp[3], *temp5 = tmp[4], *temp6 = tmp[5];
 
-  u8 checked_bytes[BYTES_ELEM_SIZE];
+  u8 *checked_bytes = (u8 *)tmp[6];
 
   // Step 1: Check that the encoding of the 
   // field element is canonical
@@ -612,7 +696,7 @@ int ristretto255_decode(ristretto255_point *ristretto_out, const u8 bytes_in[BYT
   fmul(vuu2,_v,uu2);                      // v * u2_sqr
 
   #define _I temp6
-  was_square = inv_sqrt(_I,F_ONE,vuu2);   // (was_square, invsqrt) = SQRT_RATIO_M1(1, v * u2_sqr)
+  was_square = inv_sqrt(_I,F_ONE,vuu2,tmp+6); // (was_square, invsqrt) = SQRT_RATIO_M1(1, v * u2_sqr)
 
   #define Dx temp5
   fmul(Dx,_I,u2);                         // den_x = invsqrt * u2
@@ -638,9 +722,6 @@ int ristretto255_decode(ristretto255_point *ristretto_out, const u8 bytes_in[BYT
   fe25519_reduce_emil(ristretto_out->y);
   fe25519_reduce_emil(ristretto_out->t);
 
-  WIPE_BUFFER(_s); WIPE_BUFFER(sDx); WIPE_BUFFER(u1);
-  WIPE_BUFFER(Dxv); WIPE_BUFFER(Dy); WIPE_BUFFER(_I);
-
   if (was_square == 0){
     #ifdef DEBUG_FLAG
       printf("\n\n\n ristretto255_decode: Bad encoding! was_square=%d \n\n\n",was_square);
@@ -662,6 +743,25 @@ int ristretto255_decode(ristretto255_point *ristretto_out, const u8 bytes_in[BYT
   return 0;
 }
 
+// *** STACKSIZE: 8x field_elem = 256B + (132B + 5size_t + 3int) ***
+int ristretto255_decode(ristretto255_point *ristretto_out, const u8 bytes_in[BYTES_ELEM_SIZE]){
+  field_elem tmp[8];
+  int result = decode_slots(ristretto_out, bytes_in, tmp);
+  WIPE_BUFFER(tmp);
+  return result;
+}
+
+/**
+  * @brief Decode input bytes u8[32] to ristretto255_point, temporaries in workspace
+  * @param[in]   -> bytes_in[32]
+  * @param[in]   -> ws caller-owned workspace (not wiped)
+  * @param[out]  -> ristretto_out ristretto255_point
+**/
+// *** STACKSIZE: (132B + 5size_t + 3int) ***
+int ristretto255_decode_ws(ristretto255_point *ristretto_out, const u8 bytes_in[BYTES_ELEM_SIZE], ristretto255_ws* ws){
+  return decode_slots(ristretto_out, bytes_in, ws->fe);
+}
+
 
 
 /**
@@ -678,11 +778,14 @@ int ristretto255_decode(ristretto255_point *ristretto_out, const u8 bytes_in[BYT
 // every line with draft specification.
 // DRAFT from 2023-09-18:
 // https://datatracker.ietf.org/doc/draft-irtf-cfrg-ristretto255-decaf448/
-// *** STACKSIZE: 420B + 5size_t ***
-int ristretto255_encode(u8 bytes_out[BYTES_ELEM_SIZE], const ristretto255_point* ristretto_in){
+// Temporaries are taken from caller slots tmp[9] (7 + 2 for
+// inv_sqrt) and they are not wiped here, see 
+// ristretto255_encode(_ws) below.
+// *** STACKSIZE: 9x field_elem slots + 132B + 5size_t ***
+static int encode_slots(u8 bytes_out[BYTES_ELEM_SIZE], const ristretto255_point* ristretto_in, field_elem* tmp){
 
   
-  field_elem _temp1,_temp2,_temp3,_temp4,_temp5,_temp6,_temp7;
+  u32 *_temp1 = tmp[0], *_temp2 = tmp[1], *_temp3 = tmp[2], *_temp4 = tmp[3], *_temp5 = tmp[4], *_temp6 = tmp[5], *_temp7 = tmp[6];
 
 
   #define temp_zy1 _temp1
@@ -700,7 +803,7 @@ int ristretto255_encode(u8 bytes_out[BYTES_ELEM_SIZE], const ristretto255_point*
   #define u1uu2 _temp4
   fmul(u1uu2,u1_,uu2_);                   // u1 * u2^2
   #define I_ _temp2
-  inv_sqrt(I_,F_ONE,u1uu2);               // (_, invsqrt) = SQRT_RATIO_M1(1, u1 * u2^2)
+  inv_sqrt(I_,F_ONE,u1uu2,tmp+7);         // (_, invsqrt) = SQRT_RATIO_M1(1, u1 * u2^2)
 
   #define D1_ _temp4
   fmul(D1_,u1_,I_);                       // den1 = invsqrt * u1
@@ -757,12 +860,82 @@ int ristretto255_encode(u8 bytes_out[BYTES_ELEM_SIZE], const ristretto255_point*
   
   pack25519(bytes_out,temp_s);
 
-  WIPE_BUFFER(enchanted_denominator); WIPE_BUFFER(Z_Y); WIPE_BUFFER(temp_s);
-  WIPE_BUFFER(_X); WIPE_BUFFER(_Y); WIPE_BUFFER(iX);
-  WIPE_BUFFER(iY);
   return 0;
 }
 
+// *** STACKSIZE: 9x field_elem = 288B + (132B + 5size_t) ***
+int ristretto255_encode(u8 bytes_out[BYTES_ELEM_SIZE], const ristretto255_point* ristretto_in){
+  field_elem tmp[9];
+  encode_slots(bytes_out, ristretto_in, tmp);
+  WIPE_BUFFER(tmp);
+  return 0;
+}
+
+/**
+  * @brief Encode ristretto255_point to bytes u8[32], temporaries in workspace
+  * @param[in]   -> ristretto_in ristretto255_point
+  * @param[in]   -> ws caller-owned workspace (not wiped)
+  * @param[out]  -> bytes_out[32]
+**/
+// *** STACKSIZE: (132B + 5size_t) ***
+int ristretto255_encode_ws(u8 bytes_out[BYTES_ELEM_SIZE], const ristretto255_point* ristretto_in, ristretto255_ws* ws){
+  return encode_slots(bytes_out, ristretto_in, ws->fe);
+}
+
+
+
+/**
+  * @brief Turns hash bytes[64] into ristretto255_point
+  * @param[in]   -> bytes_in[64]
+  * @param[in]   -> ws caller-owned workspace (not wiped)
+  * @param[out]  -> r ristretto255_point (can be ws->pt[0] or ws->pt[1])
+**/
+// Steps 1) - 3) of hash_to_group (see below) without final encode,
+// so callers who need point (e.g. derivation of generators)
+// do not have to encode and decode it again.
+// Both MAPs use the same slots fe[2..8], halves ft1, ft2 stay 
+// in fe[0], fe[1] and mapped points in pt[0], pt[1].
+// *** STACKSIZE: (132B + 5size_t + 2x int) ***
+static void hash_to_point_ws(ristretto255_point* r, const u8 bytes_in[HASH_BYTES_SIZE], ristretto255_ws* ws){
+  u32 *ft1 = ws->fe[0], *ft2 = ws->fe[1];
+
+  // make halves and encode them to field_elem
+  unpack25519(ft1,bytes_in);
+  unpack25519(ft2,bytes_in+32);
+
+  // MASK MSB for each half, this is equivalent to modulo 2**255
+  // This step is very important, if skipped, hash_to_group 
+  // returns invalid elements
+  ft1[7] &= 0x7FFFFFFF;
+  ft2[7] &= 0x7FFFFFFF;
+
+  MAP(&ws->pt[0],ft1,ws->fe+2); // map(ristretto_elligator) first half
+  MAP(&ws->pt[1],ft2,ws->fe+2); // map(ristretto_elligator) second half
+
+  point_addition_slots(r,&ws->pt[0],&ws->pt[1],ws->fe); // addition of 2 Edward's point
+}
+
+// *** STACKSIZE: ristretto255_ws 576B + (132B + 5size_t + 2x int) ***
+static void hash_to_point(ristretto255_point* r, const u8 bytes_in[HASH_BYTES_SIZE]){
+  ristretto255_ws ws;
+  hash_to_point_ws(r, bytes_in, &ws);
+  ristretto255_ws_wipe(&ws);
+}
+
+
+/**
+  * @brief Turns hash bytes[64] into valid ristretto point in GF, temporaries in workspace
+  * @param[in]   -> bytes_in[64]
+  * @param[in]   -> ws caller-owned workspace (not wiped)
+  * @param[out]  -> bytes_out[32]
+**/
+// Same as hash_to_group, result point is left in ws->pt[0].
+// *** STACKSIZE: (132B + 5size_t + 2x int) ***
+int hash_to_group_ws(u8 bytes_out[BYTES_ELEM_SIZE], const u8 bytes_in[HASH_BYTES_SIZE], ristretto255_ws* ws){
+  hash_to_point_ws(&ws->pt[0], bytes_in, ws);
+  encode_slots(bytes_out, &ws->pt[0], ws->fe);
+  return 0;
+}
 
 
 /**
@@ -783,44 +956,78 @@ int ristretto255_encode(u8 bytes_out[BYTES_ELEM_SIZE], const ristretto255_point*
 // 3) perform addition of 2 edward's point, note that
 // we need to add 2 edwards points so fe25519 arithmetics won't 
 // fit there we need to use function that adds 2 edwards points
-// *** STACKSIZE: 804B + 5size_t + 2x int***
+// Steps 1) - 3) are done in hash_to_point_ws
+// *** STACKSIZE: ristretto255_ws 576B + (132B + 5size_t + 2x int) ***
 int hash_to_group(u8 bytes_out[BYTES_ELEM_SIZE], const u8 bytes_in[HASH_BYTES_SIZE]){
-  ristretto255_point a_point;
-  ristretto255_point *a = &a_point;
+  ristretto255_ws ws;
 
-  ristretto255_point b_point;
-  ristretto255_point *b = &b_point;
+  hash_to_group_ws(bytes_out, bytes_in, &ws);
 
-  ristretto255_point r_point;
-  ristretto255_point *r = &r_point;
-  
+  ristretto255_ws_wipe(&ws);
+  return 0;
+}
 
-  // make halves
-  u8 t1[32], t2[32];
-  b_copy((uint32_t *)t1,(uint32_t *)bytes_in);
-  b_copy((uint32_t *)t2,(uint32_t *) (bytes_in+32));
 
-  
-  // MASK LSB for each half, this is equivalent to modulo 2**255
-  // This step is very important, if skipped, hash_to_group 
-  // returns invalid elements
-  t1[31] &= 0x7F;
-  t2[31] &= 0x7F;
+/**
+  * @brief Hash message into ristretto point with precomputed DST
+  * @param[in]   -> msg, msg_len message
+  * @param[in]   -> ctx xmd_ctx (see xmd_init in sha512.c)
+  * @param[out]  -> bytes_out[32]
+**/
+// hash_to_group(expand_message_xmd(msg, DST, 64)), which is
+// hash-to-group of RFC 9496 with expand_message_xmd(SHA-512) of 
+// RFC 9380. xmd_ctx can be shared by all messages with the same DST.
+// Peak is in expand_message_xmd, hash_to_group runs after it on
+// ristretto255_ws 576B + (132B + 5size_t + 2x int).
+// *** STACKSIZE: 64B + (1x sha512_ctx = 208B + 3x 64B + (208B + 640B + 10x u64)) ***
+int ristretto255_hash_to_group_xmd_ctx(u8 bytes_out[BYTES_ELEM_SIZE], const u8* msg, size_t msg_len, const xmd_ctx* ctx){
+  u8 uniform_bytes[HASH_BYTES_SIZE];
+
+  expand_message_xmd(uniform_bytes, HASH_BYTES_SIZE, msg, msg_len, ctx);
+  hash_to_group(bytes_out, uniform_bytes);
+
+  WIPE_BUFFER(uniform_bytes);
+  return 0;
+}
 
-  // encode t1,t2 to field_elem
 
-  field_elem ft1,ft2;
-  unpack25519(ft1,t1);
-  unpack25519(ft2,t2);
+/**
+  * @brief Hash message into ristretto point
+  * @param[in]   -> msg, msg_len message
+  * @param[in]   -> dst, dst_len domain separation tag
+  * @param[out]  -> bytes_out[32]
+**/
+// One-shot version of ristretto255_hash_to_group_xmd_ctx, if you
+// hash many messages with the same DST, use xmd_init once and
+// ristretto255_hash_to_group_xmd_ctx instead.
+// *** STACKSIZE: 1x xmd_ctx = 472B + (64B + (1x sha512_ctx = 208B + 3x 64B + (208B + 640B + 10x u64))) ***
+int ristretto255_hash_to_group_xmd(u8 bytes_out[BYTES_ELEM_SIZE], const u8* msg, size_t msg_len, const u8* dst, size_t dst_len){
+  xmd_ctx ctx;
 
-  MAP(a,ft1); // map(ristretto_elligator) first half
-  MAP(b,ft2); // map(ristretto_elligator) second hal
+  xmd_init(&ctx, dst, dst_len);
+  ristretto255_hash_to_group_xmd_ctx(bytes_out, msg, msg_len, &ctx);
 
-  ristretto255_point_addition(r,a,b); // addition of 2 Edward's point
+  crypto_wipe(&ctx, sizeof(ctx));
+  return 0;
+}
 
-  ristretto255_encode(bytes_out, r);
 
-  WIPE_PT(&a_point); WIPE_PT(&b_point); WIPE_PT(&r_point);
+/**
+  * @brief Hash array of messages into ristretto points with precomputed DST
+  * @param[in]   -> msgs array of len messages
+  * @param[in]   -> msg_lens array of len message lengths
+  * @param[in]   -> ctx xmd_ctx (see xmd_init in sha512.c)
+  * @param[out]  -> bytes_out array of len u8[32]
+**/
+// Batch version of ristretto255_hash_to_group_xmd_ctx, DST part of 
+// hashing is precomputed only once in ctx.
+// *** STACKSIZE: size_t + (64B + (1x sha512_ctx = 208B + 3x 64B + (208B + 640B + 10x u64))) ***
+int ristretto255_hash_to_group_xmd_batch(u8 bytes_out[][BYTES_ELEM_SIZE], const u8* const msgs[], const size_t msg_lens[], size_t len, const xmd_ctx* ctx){
+  size_t i;
+
+  FOR(i, 0, len){
+    ristretto255_hash_to_group_xmd_ctx(bytes_out[i], msgs[i], msg_lens[i], ctx);
+  }
   return 0;
 }
 
@@ -835,21 +1042,63 @@ int hash_to_group(u8 bytes_out[BYTES_ELEM_SIZE], const u8 bytes_in[HASH_BYTES_SI
 // ristretto_point q * scalar s
 // Note that scalar "s" is represented as u8[32]
 // Inspired by tweetNaCl: https://github.com/dominictarr/tweetnacl/blob/master/tweetnacl.c#L632
-// *** STACKSIZE: 293B+ 4size_t +int***
-void ristretto255_scalarmult(ristretto255_point* p, ristretto255_point* q,const u8 *s){
+// All 512 additions reuse the same slots tmp[5], so temporaries
+// are wiped only once by the caller instead of after every addition.
+// Only lower "bits" bits of s are processed (256 for full scalar).
+// *** STACKSIZE: 5x field_elem slots + 132B + 4size_t + int ***
+static void scalarmult_slots(ristretto255_point* p, ristretto255_point* q,const u8 *s, int bits, field_elem* tmp){
   fcopy(p->x,F_ZERO);
   fcopy(p->y,F_ONE);
   fcopy(p->z,F_ONE);
   fcopy(p->t,F_ZERO);
-  for (int i = 255;i >= 0;--i) {
+  for (int i = bits-1;i >= 0;--i) {
     u8 b = (s[i/8]>>(i&7))&1;
     cswap(p,q,b);
-    ristretto255_point_addition(q,q,p);
-    ristretto255_point_addition(p,p,p);
+    point_addition_slots(q,q,p,tmp);
+    point_addition_slots(p,p,p,tmp);
     cswap(p,q,b);
   }
 }
 
+// *** STACKSIZE: 5x field_elem = 160B + (132B + 4size_t + int) ***
+void ristretto255_scalarmult(ristretto255_point* p, ristretto255_point* q,const u8 *s){
+  field_elem tmp[5];
+  scalarmult_slots(p, q, s, 256, tmp);
+  WIPE_BUFFER(tmp);
+}
+
+/**
+  * @brief Scalar multiplication, temporaries in workspace
+  * @param[in]   -> q ristretto255_point (modified, same as ristretto255_scalarmult)
+  * @param[in]   -> s scalar u8[32]
+  * @param[in]   -> ws caller-owned workspace (not wiped)
+  * @param[out]  -> p ristretto255_point
+**/
+// *** STACKSIZE: (132B + 4size_t + int) ***
+void ristretto255_scalarmult_ws(ristretto255_point* p, ristretto255_point* q,const u8 *s, ristretto255_ws* ws){
+  scalarmult_slots(p, q, s, 256, ws->fe);
+}
+
+#ifdef LOW_STACK_FLAG
+// Ladder used instead of fixed-window method in LOW_STACK_FLAG
+// profile (no window table of 8 cached points on stack), input
+// point is copied, so it is left untouched and r can be the same
+// as q. Running time depends only on "bits".
+// *** STACKSIZE: 1x ristretto255_point = 128B + 5x field_elem = 160B + (132B + 4size_t + int) ***
+static void scalarmult_ladder_bits(ristretto255_point* r, const ristretto255_point* q, const u8 sc[BYTES_ELEM_SIZE], int bits){
+  ristretto255_point base = *q;
+  field_elem tmp[5];
+  scalarmult_slots(r, &base, sc, bits, tmp);
+  WIPE_PT(&base); WIPE_BUFFER(tmp);
+}
+#endif
+
+
+
+
+
+
+
 
 
 
@@ -882,6 +1131,1108 @@ void ristretto255_scalarmult(ristretto255_point* p, ristretto255_point* q,const
 
 
 
+/**
+  * @brief Add ristretto255_point and affine-Niels point (mixed addition)
+  * @param[in]   -> p ristretto255_point
+  * @param[in]   -> q ristretto255_niels_point
+  * @param[out]  -> r ristretto255_point
+**/
+// Mixed addition r = p + q, where q is in affine-Niels form 
+// (Y+X, Y-X, 2*D*T) with Z = 1 (see helpers.h). Formula is the same
+// as in ristretto255_point_addition, but since Z2 = 1 and 
+// Y2+X2, Y2-X2, 2*D*T2 are precomputed, we need 7 fmul instead of 9.
+// Note that r can be the same pointer as p.
+// *** STACKSIZE: 292B+ 4size_t ***
+void ristretto255_point_addition_niels(ristretto255_point* r,const ristretto255_point* p,const ristretto255_niels_point* q){
+    field_elem temp_1,temp_2,temp_3,temp_4,temp_5;
+
+    fsub(temp_1, p->y, p->x);
+    fmul(temp_1, temp_1, q->ymx);         // A = (Y1-X1)*(Y2-X2)
+    fadd(temp_2, p->y, p->x);
+    fmul(temp_2, temp_2, q->ypx);         // B = (Y1+X1)*(Y2+X2)
+
+    fsub(temp_5, temp_2, temp_1);         // E = B-A
+    fadd(temp_2, temp_2, temp_1);         // H = B+A
+
+    fadd(temp_1, p->z, p->z);             // D = 2*Z1
+    fmul(temp_3, p->t, q->xy2d);          // C = T1*2*D*T2
+    fsub(temp_4, temp_1, temp_3);         // F = D-C
+    fadd(temp_3, temp_1, temp_3);         // G = D+C
+
+    fmul(r->x, temp_5, temp_4);           // X3 = E*F
+    fmul(r->y, temp_2, temp_3);           // Y3 = H*G
+    fmul(r->z, temp_3, temp_4);           // Z3 = G*F
+    fmul(r->t, temp_5, temp_2);           // T3 = E*H
+
+    WIPE_BUFFER(temp_1); WIPE_BUFFER(temp_2); WIPE_BUFFER(temp_3);
+    WIPE_BUFFER(temp_4); WIPE_BUFFER(temp_5);
+}
+
+
+/**
+  * @brief Batch normalization of ristretto255_points to Z = 1
+  * @param[in]   -> in array of ristretto255_point
+  * @param[in]   -> len number of points
+  * @param[out]  -> out array of ristretto255_point (x/z, y/z, 1, xy/z^2)
+**/
+// Normalization needs inversion of every Z coordinate, which is
+// expensive (see finv). We use Montgomery's trick, so only one finv
+// and 3*(len-1) fmul are needed for the whole batch:
+// 1) out[i].t = Z0*Z1*...*Zi  (prefix products)
+// 2) inv = (Z0*Z1*...*Zn-1)^-1
+// 3) going backwards Zi^-1 = inv * out[i-1].t, inv = inv * Zi
+// Note that prefix products are stored in out[i].t, so we do not need
+// any extra memory, and out can be the same array as in (in-place).
+// All input points need to have Z != 0, which holds for every valid
+// ristretto255_point.
+// *** STACKSIZE: 3x field_elem = 228B + 5size_t ***
+void ristretto255_batch_normalize(ristretto255_point* out, const ristretto255_point* in, size_t len){
+    field_elem inv, z_inv, z_in;
+    size_t i;
+
+    if (len == 0){
+      return;
+    }
+
+    // prefix products
+    fcopy(out[0].t, in[0].z);
+    FOR(i, 1, len){
+      fmul(out[i].t, out[i-1].t, in[i].z);
+    }
+
+    finv(inv, out[len-1].t);
+
+    for (i = len; i-- > 0;){
+      fcopy(z_in, in[i].z);
+      if (i > 0){
+        fmul(z_inv, inv, out[i-1].t);     // Zi^-1
+        fmul(inv, inv, z_in);             // (Z0*...*Zi-1)^-1
+      } else {
+        fcopy(z_inv, inv);
+      }
+      fmul(out[i].x, in[i].x, z_inv);     // x = X/Z
+      fmul(out[i].y, in[i].y, z_inv);     // y = Y/Z
+      fcopy(out[i].z, F_ONE);             // z = 1
+      fmul(out[i].t, out[i].x, out[i].y); // t = x*y
+    }
+
+    WIPE_BUFFER(inv); WIPE_BUFFER(z_inv); WIPE_BUFFER(z_in);
+}
+
+
+/**
+  * @brief Batch conversion of ristretto255_points to affine-Niels form
+  * @param[in]   -> in array of ristretto255_point
+  * @param[in]   -> len number of points
+  * @param[out]  -> out array of ristretto255_niels_point
+**/
+// Same as ristretto255_batch_normalize (one finv for the whole batch
+// thanks to Montgomery's trick), but result is written in affine-Niels
+// form (y+x, y-x, 2*D*x*y), suitable for precomputed tables and
+// mixed addition (ristretto255_point_addition_niels).
+// Prefix products are stored in out[i].xy2d.
+// *** STACKSIZE: 4x field_elem = 260B + 5size_t ***
+void ristretto255_batch_to_niels(ristretto255_niels_point* out, const ristretto255_point* in, size_t len){
+    field_elem inv, z_inv, x_aff, y_aff;
+    size_t i;
+
+    if (len == 0){
+      return;
+    }
+
+    // prefix products
+    fcopy(out[0].xy2d, in[0].z);
+    FOR(i, 1, len){
+      fmul(out[i].xy2d, out[i-1].xy2d, in[i].z);
+    }
+
+    finv(inv, out[len-1].xy2d);
+
+    for (i = len; i-- > 0;){
+      if (i > 0){
+        fmul(z_inv, inv, out[i-1].xy2d);  // Zi^-1
+        fmul(inv, inv, in[i].z);          // (Z0*...*Zi-1)^-1
+      } else {
+        fcopy(z_inv, inv);
+      }
+      fmul(x_aff, in[i].x, z_inv);        // x = X/Z
+      fmul(y_aff, in[i].y, z_inv);        // y = Y/Z
+      fadd(out[i].ypx, y_aff, x_aff);     // y+x
+      fsub(out[i].ymx, y_aff, x_aff);     // y-x
+      fmul(out[i].xy2d, x_aff, y_aff);
+      fmul(out[i].xy2d, out[i].xy2d, EDWARDS_D2); // 2*D*x*y
+    }
+
+    WIPE_BUFFER(inv); WIPE_BUFFER(z_inv);
+    WIPE_BUFFER(x_aff); WIPE_BUFFER(y_aff);
+}
+
+
+/**
+  * @brief Returns 1 if two ristretto255_points are equal
+  * @param[in]   -> p ristretto255_point
+  * @param[in]   -> q ristretto255_point
+  * @param[out]  -> Boolean: True/False
+**/
+// Equality check from ristretto draft, two points are equal iff
+// X1*Y2 == Y1*X2 or Y1*Y2 == X1*X2. This is much cheaper than 
+// ristretto255_encode of both points + bytes_eq_32 (4 fmul instead 
+// of 2 inv_sqrt). Note that we use bitwise OR so the check is
+// performed in constant time.
+// *** STACKSIZE: 2x field_elem = 196B + 4size_t ***
+int ristretto255_point_eq(const ristretto255_point* p, const ristretto255_point* q){
+    field_elem lhs, rhs;
+    int eq_xy, eq_yy;
+
+    fmul(lhs, p->x, q->y);                // X1*Y2
+    fmul(rhs, p->y, q->x);                // Y1*X2
+    eq_xy = feq(lhs, rhs);
+
+    fmul(lhs, p->y, q->y);                // Y1*Y2
+    fmul(rhs, p->x, q->x);                // X1*X2
+    eq_yy = feq(lhs, rhs);
+
+    WIPE_BUFFER(lhs); WIPE_BUFFER(rhs);
+    return eq_xy | eq_yy;
+}
+
+
+/**
+  * @brief Returns 1 if ristretto255_point is identity
+  * @param[in]   -> p ristretto255_point
+  * @param[out]  -> Boolean: True/False
+**/
+// Equivalent of ristretto255_point_eq(p, identity), where
+// identity = (0, 1, 1, 0), so the check reduces to X == 0 or Y == 0
+// and no fmul is needed.
+// *** STACKSIZE: 4B + size_t ***
+int ristretto255_is_identity(const ristretto255_point* p){
+    return feq(p->x, F_ZERO) | feq(p->y, F_ZERO);
+}
 
 
+/**
+  * @brief Doubling of ristretto255_point
+  * @param[in]   -> p ristretto255_point
+  * @param[out]  -> r = 2*p ristretto255_point
+**/
+// Dedicated doubling for extended coords (a = -1), 
+// "dbl-2008-hwcd" from https://hyperelliptic.org/EFD/g1p/auto-twisted-extended-1.html
+// costs 4 fmul + 4 pow2, compared to 9 fmul of
+// ristretto255_point_addition(r,p,p). Note that r can be the same 
+// pointer as p.
+// *** STACKSIZE: 4x field_elem = 260B + 4size_t ***
+static void point_double(ristretto255_point* r, const ristretto255_point* p){
+    field_elem temp_1,temp_2,temp_3,temp_4;
+
+    pow2(temp_1, p->x);                   // A = X^2
+    pow2(temp_2, p->y);                   // B = Y^2
+    pow2(temp_3, p->z);
+    fadd(temp_3, temp_3, temp_3);         // C = 2*Z^2
+    fadd(temp_4, p->x, p->y);
+    pow2(temp_4, temp_4);                 // (X+Y)^2
+
+    fadd(r->y, temp_1, temp_2);           // H = A+B (stored in r->y)
+    fsub(temp_4, r->y, temp_4);           // E = H-(X+Y)^2
+    fsub(temp_1, temp_1, temp_2);         // G = A-B
+    fadd(temp_3, temp_3, temp_1);         // F = C+G
+
+    fmul(r->t, temp_4, r->y);             // T3 = E*H
+    fmul(r->y, temp_1, r->y);             // Y3 = G*H
+    fmul(r->x, temp_4, temp_3);           // X3 = E*F
+    fmul(r->z, temp_3, temp_1);           // Z3 = F*G
+
+    WIPE_BUFFER(temp_1); WIPE_BUFFER(temp_2);
+    WIPE_BUFFER(temp_3); WIPE_BUFFER(temp_4);
+}
+
+
+/**
+  * @brief Conversion of ristretto255_point to cached form
+  * @param[in]   -> p ristretto255_point
+  * @param[out]  -> r ristretto255_cached_point
+**/
+// r = (Y+X, Y-X, Z, 2*D*T), see helpers.h
+// *** STACKSIZE: 132B + 4size_t ***
+static void point_to_cached(ristretto255_cached_point* r, const ristretto255_point* p){
+    fadd(r->ypx, p->y, p->x);
+    fsub(r->ymx, p->y, p->x);
+    fcopy(r->z, p->z);
+    fmul(r->t2d, p->t, EDWARDS_D2);
+}
+
+
+/**
+  * @brief Add ristretto255_point and cached point
+  * @param[in]   -> p ristretto255_point
+  * @param[in]   -> q ristretto255_cached_point
+  * @param[out]  -> r ristretto255_point
+**/
+// Same formula as ristretto255_point_addition, with precomputed 
+// Y2+X2, Y2-X2, 2*D*T2 (8 fmul instead of 9).
+// Note that r can be the same pointer as p.
+// *** STACKSIZE: 292B+ 4size_t ***
+static void point_addition_cached(ristretto255_point* r,const ristretto255_point* p,const ristretto255_cached_point* q){
+    field_elem temp_1,temp_2,temp_3,temp_4,temp_5;
+
+    fsub(temp_1, p->y, p->x);
+    fmul(temp_1, temp_1, q->ymx);         // A = (Y1-X1)*(Y2-X2)
+    fadd(temp_2, p->y, p->x);
+    fmul(temp_2, temp_2, q->ypx);         // B = (Y1+X1)*(Y2+X2)
+
+    fsub(temp_5, temp_2, temp_1);         // E = B-A
+    fadd(temp_2, temp_2, temp_1);         // H = B+A
+
+    fmul(temp_1, p->z, q->z);
+    fadd(temp_1, temp_1, temp_1);         // D = 2*Z1*Z2
+    fmul(temp_3, p->t, q->t2d);           // C = T1*2*D*T2
+    fsub(temp_4, temp_1, temp_3);         // F = D-C
+    fadd(temp_3, temp_1, temp_3);         // G = D+C
+
+    fmul(r->x, temp_5, temp_4);           // X3 = E*F
+    fmul(r->y, temp_2, temp_3);           // Y3 = H*G
+    fmul(r->z, temp_3, temp_4);           // Z3 = G*F
+    fmul(r->t, temp_5, temp_2);           // T3 = E*H
+
+    WIPE_BUFFER(temp_1); WIPE_BUFFER(temp_2); WIPE_BUFFER(temp_3);
+    WIPE_BUFFER(temp_4); WIPE_BUFFER(temp_5);
+}
+
+
+/**
+  * @brief Conditional move of field_elem if cond is set to 1
+  * @param[in/out]   -> dst
+  * @param[in]       -> src
+  * @param[in]       -> cond if set to 1, dst = src
+**/
+// Same masking logic as in gf25519Swap, but src stays untouched
+// and we do not need temporary copy of src.
+// *** STACKSIZE: u32 + size_t ***
+static void fcmov(field_elem dst, const field_elem src, u32 cond){
+    u32 mask = ~cond + 1;                 // all-1 or all-0 word
+    size_t i;
+    FOR(i, 0, FIELED_ELEM_SIZE){
+      dst[i] ^= mask & (dst[i] ^ src[i]);
+    }
+}
 
+
+/**
+  * @brief Signed radix-16 recoding of lower "bits" bits of scalar
+  * @param[in]   -> sc scalar u8[32]
+  * @param[in]   -> bits number of processed bits (1 - 256)
+  * @param[out]  -> digits, sc mod 2^bits = sum(digits[i] * 16^i)
+  * @param[out]  -> number of digits, ceil(bits/4) + 1
+**/
+// Every digit is in range [-8, 8), so we need only 8 precomputed
+// multiples of point in window table and conditional negation.
+// Since scalar is arbitrary number, there is one extra carry digit
+// (0 or 1) on top, e.g. at position 64 for 256-bit scalar.
+// Bits of scalar above "bits" are ignored. Note that "bits" is 
+// considered public, recoding uses only arithmetic operations, 
+// so it runs in constant time with respect to scalar.
+// Inspired by ref10 (ge_scalarmult_base):
+// https://github.com/jedisct1/libsodium/blob/master/src/libsodium/crypto_core/ed25519/ref10/ed25519_ref10.c
+// *** STACKSIZE: 3x int ***
+static int scalar_recode_radix16(signed char digits[SCALAR_DIGITS], const u8 sc[BYTES_ELEM_SIZE], int bits){
+    int i, carry, nibbles;
+
+    nibbles = (bits + 3) / 4;
+    FOR(i, 0, nibbles){
+      digits[i] = (sc[i/2] >> (4*(i&1))) & 15;
+    }
+    // mask bits above "bits" in the most significant nibble
+    if (bits & 3){
+      digits[nibbles-1] &= (1 << (bits & 3)) - 1;
+    }
+    carry = 0;
+    FOR(i, 0, nibbles){
+      digits[i] += carry;
+      carry = (digits[i] + 8) >> 4;
+      digits[i] -= carry * 16;
+    }
+    digits[nibbles] = carry;
+    return nibbles + 1;
+}
+
+
+/**
+  * @brief Fill window table with P, 2P, ..., 8P
+  * @param[in]   -> p ristretto255_point
+  * @param[out]  -> table of WINDOW_TABLE_SIZE cached points
+**/
+// Table is built with 1 point_double and 6 point_addition_cached.
+// *** STACKSIZE: 1x ristretto255_point = 128B + (292B+ 4size_t) ***
+static void window_table_build(ristretto255_cached_point table[WINDOW_TABLE_SIZE], const ristretto255_point* p){
+    ristretto255_point multiple;
+    int i;
+
+    point_to_cached(&table[0], p);        // P
+    point_double(&multiple, p);
+    point_to_cached(&table[1], &multiple); // 2P
+    FOR(i, 2, WINDOW_TABLE_SIZE){
+      point_addition_cached(&multiple, &multiple, &table[0]);
+      point_to_cached(&table[i], &multiple); // (i+1)P = iP + P
+    }
+
+    WIPE_PT(&multiple);
+}
+
+
+/**
+  * @brief Returns 1 if x == y, in constant time
+  * @param[in]   -> x
+  * @param[in]   -> y
+  * @param[out]  -> Boolean: True/False
+**/
+// *** STACKSIZE: u32 ***
+static u32 ct_eq_u8(u8 x, u8 y){
+    u32 diff = x ^ y;
+    diff -= 1;                            // underflow only if x == y
+    return diff >> 31;
+}
+
+
+/**
+  * @brief Constant-time lookup of digit*P from window table
+  * @param[in]   -> table of P, 2P, ..., 8P
+  * @param[in]   -> digit in range [-8, 8]
+  * @param[out]  -> r = digit*P ristretto255_cached_point
+**/
+// Every entry of table is touched, so memory access pattern does not
+// depend on (secret) digit. Negative digits are handled by
+// conditional negation: -(Y+X, Y-X, Z, 2DT) = (Y-X, Y+X, Z, -2DT).
+// *** STACKSIZE: 1x field_elem = 40B + (60B + 3size_t) + 2x u32 ***
+static void window_table_select(ristretto255_cached_point* r, const ristretto255_cached_point table[WINDOW_TABLE_SIZE], signed char digit){
+    field_elem neg_t2d;
+    u32 negative = ((u8) digit) >> 7;
+    u8 digit_abs = (u8)(digit - ((-(signed char)negative & digit) * 2));
+    int i;
+
+    // identity (1, 1, 1, 0)
+    fcopy(r->ypx, F_ONE);
+    fcopy(r->ymx, F_ONE);
+    fcopy(r->z, F_ONE);
+    fcopy(r->t2d, F_ZERO);
+
+    FOR(i, 0, WINDOW_TABLE_SIZE){
+      u32 cond = ct_eq_u8(digit_abs, (u8)(i+1));
+      fcmov(r->ypx, table[i].ypx, cond);
+      fcmov(r->ymx, table[i].ymx, cond);
+      fcmov(r->z, table[i].z, cond);
+      fcmov(r->t2d, table[i].t2d, cond);
+    }
+
+    swap25519(r->ypx, r->ymx, negative);
+    fneg(neg_t2d, r->t2d);
+    fcmov(r->t2d, neg_t2d, negative);
+
+    WIPE_BUFFER(neg_t2d);
+}
+
+
+/**
+  * @brief Fixed-window scalar multiplication with precomputed table
+  * @param[in]   -> table of P, 2P, ..., 8P (see window_table_build)
+  * @param[in]   -> digits signed radix-16 digits of scalar
+  * @param[in]   -> digits_len number of digits
+  * @param[out]  -> r = scalar*P ristretto255_point
+**/
+// Horner's scheme over radix-16 digits, starting from the most 
+// significant one. Every step performs 4 point_double and 
+// 1 point_addition_cached (also for zero digit, which selects 
+// identity), so the sequence of operations depends only on 
+// digits_len, not on the value of scalar.
+// *** STACKSIZE: 1x ristretto255_cached_point = 128B + (292B+ 4size_t) ***
+static void scalarmult_window(ristretto255_point* r, const ristretto255_cached_point table[WINDOW_TABLE_SIZE], const signed char* digits, int digits_len){
+    ristretto255_cached_point selected;
+    int i, j;
+
+    fcopy(r->x,F_ZERO);
+    fcopy(r->y,F_ONE);
+    fcopy(r->z,F_ONE);
+    fcopy(r->t,F_ZERO);
+
+    for (i = digits_len-1; i >= 0; --i){
+      // doubling of identity is skipped, note that this does not
+      // depend on scalar
+      if (i != digits_len-1){
+        FOR(j, 0, 4){
+          point_double(r, r);
+        }
+      }
+      window_table_select(&selected, table, digits[i]);
+      point_addition_cached(r, r, &selected);
+    }
+
+    WIPE_BUFFER(selected.ypx); WIPE_BUFFER(selected.ymx);
+    WIPE_BUFFER(selected.z); WIPE_BUFFER(selected.t2d);
+}
+
+
+/**
+  * @brief Multiply many ristretto255_points by the same scalar
+  * @param[in]   -> points array of ristretto255_point
+  * @param[in]   -> sc scalar u8[32]
+  * @param[in]   -> len number of points
+  * @param[out]  -> out array of ristretto255_point, out[i] = sc*points[i]
+**/
+// Scalar is recoded (scalar_recode_radix16) only once and reused for
+// every point, per point we build window table of 8 multiples and
+// perform fixed-window multiplication, which is approximately
+// 1.5x faster than ristretto255_scalarmult (ladder with 
+// 2 additions per bit). Every point is processed in constant time 
+// with respect to scalar. Unlike ristretto255_scalarmult, input
+// points are left untouched and out can be the same array as points.
+// In LOW_STACK_FLAG profile, this and other fixed-window batch 
+// functions use ladder instead (see scalarmult_ladder_bits).
+// *** STACKSIZE: 65B + 8x ristretto255_cached_point = 1024B + (420B + 4size_t) ***
+void ristretto255_scalarmult_many(ristretto255_point out[], const ristretto255_point points[], const u8 sc[BYTES_ELEM_SIZE], size_t len){
+#ifdef LOW_STACK_FLAG
+    size_t i;
+
+    FOR(i, 0, len){
+      scalarmult_ladder_bits(&out[i], &points[i], sc, 256);
+    }
+#else
+    signed char digits[SCALAR_DIGITS];
+    ristretto255_cached_point table[WINDOW_TABLE_SIZE];
+    size_t i;
+
+    scalar_recode_radix16(digits, sc, 256);
+    FOR(i, 0, len){
+      window_table_build(table, &points[i]);
+      scalarmult_window(&out[i], table, digits, SCALAR_DIGITS);
+    }
+
+    WIPE_BUFFER(digits); WIPE_BUFFER(table);
+#endif
+}
+
+
+/**
+  * @brief Scalar multiplication of ristretto255_point by short scalar
+  * @param[in]   -> q ristretto255_point
+  * @param[in]   -> sc scalar u8[32]
+  * @param[in]   -> bits bit length of scalar (1 - 256)
+  * @param[out]  -> p = (sc mod 2^bits)*q ristretto255_point
+**/
+// Variant of ristretto255_scalarmult for scalars that are known to be
+// short (randomizers in batch verification, challenges, small 
+// integers, ...). Only lower "bits" bits of sc are recoded and 
+// processed, with fixed-window method, so e.g. 128-bit scalar costs
+// approximately half of the 256-bit one. Bits above "bits" are 
+// ignored. Running time depends only on "bits" (public value),
+// not on the value of scalar. Input point q is left untouched.
+// *** STACKSIZE: 65B + 8x ristretto255_cached_point = 1024B + (420B + 4size_t) ***
+void ristretto255_scalarmult_bits(ristretto255_point* p, const ristretto255_point* q, const u8 sc[BYTES_ELEM_SIZE], int bits){
+    ristretto255_scalarmult_batch_bits(p, q, (const u8 (*)[BYTES_ELEM_SIZE]) sc, 1, bits);
+}
+
+
+/**
+  * @brief Batch scalar multiplication by short scalars
+  * @param[in]   -> points array of ristretto255_point
+  * @param[in]   -> scalars array of scalars u8[32]
+  * @param[in]   -> len number of points/scalars
+  * @param[in]   -> bits bit length of every scalar (1 - 256)
+  * @param[out]  -> out array of ristretto255_point, out[i] = (scalars[i] mod 2^bits)*points[i]
+**/
+// Batch version of ristretto255_scalarmult_bits, for distinct points
+// and distinct scalars (results are not summed). Items are processed
+// one after another with the same digits and window table buffer,
+// so stack usage does not grow with len, use bits = 256 for full
+// scalars. Every item is processed in constant time with respect to
+// its scalar.
+// *** STACKSIZE: 65B + 8x ristretto255_cached_point = 1024B + (420B + 4size_t) ***
+void ristretto255_scalarmult_batch_bits(ristretto255_point out[], const ristretto255_point points[], const u8 scalars[][BYTES_ELEM_SIZE], size_t len, int bits){
+#ifdef LOW_STACK_FLAG
+    size_t i;
+
+    if (bits > 256){
+      bits = 256;
+    }
+    FOR(i, 0, len){
+      // bits <= 0 results in identity
+      scalarmult_ladder_bits(&out[i], &points[i], scalars[i], bits > 0 ? bits : 0);
+    }
+#else
+    signed char digits[SCALAR_DIGITS];
+    ristretto255_cached_point table[WINDOW_TABLE_SIZE];
+    int digits_len;
+    size_t i;
+
+    if (bits > 256){
+      bits = 256;
+    }
+    FOR(i, 0, len){
+      if (bits <= 0){
+        // empty scalar, result is identity
+        fcopy(out[i].x,F_ZERO);
+        fcopy(out[i].y,F_ONE);
+        fcopy(out[i].z,F_ONE);
+        fcopy(out[i].t,F_ZERO);
+        continue;
+      }
+      digits_len = scalar_recode_radix16(digits, scalars[i], bits);
+      window_table_build(table, &points[i]);
+      scalarmult_window(&out[i], table, digits, digits_len);
+    }
+
+    WIPE_BUFFER(digits); WIPE_BUFFER(table);
+#endif
+}
+
+
+/**
+  * @brief Sum of array of ristretto255_points
+  * @param[in]   -> points array of ristretto255_point
+  * @param[in]   -> len number of points
+  * @param[out]  -> out = points[0] + ... + points[len-1] ristretto255_point
+**/
+// Plain sum of many points (aggregation of public keys, commitments,
+// buckets, ...), len = 0 results in identity. Every term costs one 
+// ristretto255_point_addition (9 fmul). Note that on twisted Edwards
+// curve batch-affine addition does not pay off (affine addition 
+// needs 2 denominators, so even with shared inversion it costs 
+// more than 9 fmul). If the same set of points is summed repeatedly,
+// convert it once with ristretto255_batch_to_niels and use 
+// ristretto255_point_sum_niels (7 fmul per term).
+// *** STACKSIZE: 1x ristretto255_point = 128B + (292B+ 4size_t) ***
+void ristretto255_point_sum(ristretto255_point* out, const ristretto255_point points[], size_t len){
+    ristretto255_point acc;
+    size_t i;
+
+    fcopy(acc.x,F_ZERO);
+    fcopy(acc.y,F_ONE);
+    fcopy(acc.z,F_ONE);
+    fcopy(acc.t,F_ZERO);
+    FOR(i, 0, len){
+      ristretto255_point_addition(&acc, &acc, &points[i]);
+    }
+    *out = acc;
+
+    WIPE_PT(&acc);
+}
+
+
+/**
+  * @brief Sum of array of affine-Niels points
+  * @param[in]   -> points array of ristretto255_niels_point
+  * @param[in]   -> len number of points
+  * @param[out]  -> out = points[0] + ... + points[len-1] ristretto255_point
+**/
+// Same as ristretto255_point_sum, but every term is added with
+// mixed addition (ristretto255_point_addition_niels), which costs
+// 7 fmul instead of 9. Points can be obtained from 
+// ristretto255_batch_to_niels (one field inversion per whole batch).
+// *** STACKSIZE: 1x ristretto255_point = 128B + (292B+ 4size_t) ***
+void ristretto255_point_sum_niels(ristretto255_point* out, const ristretto255_niels_point points[], size_t len){
+    ristretto255_point acc;
+    size_t i;
+
+    fcopy(acc.x,F_ZERO);
+    fcopy(acc.y,F_ONE);
+    fcopy(acc.z,F_ONE);
+    fcopy(acc.t,F_ZERO);
+    FOR(i, 0, len){
+      ristretto255_point_addition_niels(&acc, &acc, &points[i]);
+    }
+    *out = acc;
+
+    WIPE_PT(&acc);
+}
+
+
+/**
+  * @brief Export ristretto255_point to uncompressed affine bytes u8[64]
+  * @param[in]   -> p ristretto255_point
+  * @param[out]  -> bytes_out[64] = x || y
+**/
+// Trusted wire format: affine coords x = X/Z, y = Y/Z, both in
+// canonical little-endian form. Unlike ristretto255_encode, export
+// does not need inv_sqrt, just one finv, and its import is almost
+// free (see ristretto255_import_affine). Note that this is NOT
+// canonical ristretto255 encoding, different representatives of
+// the same ristretto255 point have different exports, so use it only
+// between trusted parties and never compare exports bytewise.
+// For many points use ristretto255_export_affine_batch.
+// *** STACKSIZE: 4x field_elem = 260B + 5size_t ***
+int ristretto255_export_affine(u8 bytes_out[AFFINE_BYTES_SIZE], const ristretto255_point* p){
+    ristretto255_export_affine_batch((u8 (*)[AFFINE_BYTES_SIZE]) bytes_out, p, 1);
+    return 0;
+}
+
+
+/**
+  * @brief Batch export of ristretto255_points to affine bytes
+  * @param[in]   -> points array of ristretto255_point
+  * @param[in]   -> len number of points
+  * @param[out]  -> bytes_out array of u8[64]
+**/
+// Same as ristretto255_export_affine, but Z coords are inverted with
+// Montgomery's trick (one finv per batch, see 
+// ristretto255_batch_normalize). Prefix products are stored in 
+// y half of bytes_out, so no extra memory is needed.
+// *** STACKSIZE: 4x field_elem = 260B + 5size_t ***
+void ristretto255_export_affine_batch(u8 bytes_out[][AFFINE_BYTES_SIZE], const ristretto255_point points[], size_t len){
+    field_elem inv, z_inv, prefix, coord;
+    size_t i;
+
+    if (len == 0){
+      return;
+    }
+
+    // prefix products
+    fcopy(prefix, points[0].z);
+    pack25519(bytes_out[0]+BYTES_ELEM_SIZE, prefix);
+    FOR(i, 1, len){
+      fmul(prefix, prefix, points[i].z);
+      pack25519(bytes_out[i]+BYTES_ELEM_SIZE, prefix);
+    }
+
+    finv(inv, prefix);
+
+    for (i = len; i-- > 0;){
+      if (i > 0){
+        unpack25519(prefix, bytes_out[i-1]+BYTES_ELEM_SIZE);
+        fmul(z_inv, inv, prefix);         // Zi^-1
+        fmul(inv, inv, points[i].z);      // (Z0*...*Zi-1)^-1
+      } else {
+        fcopy(z_inv, inv);
+      }
+      fmul(coord, points[i].x, z_inv);    // x = X/Z
+      pack25519(bytes_out[i], coord);
+      fmul(coord, points[i].y, z_inv);    // y = Y/Z
+      pack25519(bytes_out[i]+BYTES_ELEM_SIZE, coord);
+    }
+
+    WIPE_BUFFER(inv); WIPE_BUFFER(z_inv);
+    WIPE_BUFFER(prefix); WIPE_BUFFER(coord);
+}
+
+
+/**
+  * @brief Import ristretto255_point from uncompressed affine bytes u8[64]
+  * @param[in]   -> bytes_in[64] = x || y
+  * @param[out]  -> p ristretto255_point
+  * @param[out]  -> 0 on success, 1 if input is not valid
+**/
+// Counterpart of ristretto255_export_affine. Instead of full 
+// ristretto255_decode (inv_sqrt) we only check that both coords
+// are canonical and that (x, y) lies on the curve:
+// -x^2 + y^2 = 1 + D*x^2*y^2 (4 fmul, no exponentiation).
+// Note that this check does NOT guarantee that point was produced
+// by ristretto255 operations (e.g. it accepts small order points),
+// so use this format only between trusted parties and keep 
+// ristretto255_decode on trust boundaries.
+// *** STACKSIZE: 2x field_elem = 196B + 4size_t + 2x int ***
+int ristretto255_import_affine(ristretto255_point* p, const u8 bytes_in[AFFINE_BYTES_SIZE]){
+    field_elem lhs, rhs;
+    int is_canonical, on_curve;
+
+    unpack25519(p->x, bytes_in);
+    unpack25519(p->y, bytes_in+BYTES_ELEM_SIZE);
+
+    // canonical iff x < 2^255-19 and y < 2^255-19
+    carry25519(lhs, p->x);
+    carry25519(rhs, p->y);
+    is_canonical = feq(lhs, p->x) & feq(rhs, p->y);
+    is_canonical &= ((p->x[7] | p->y[7]) >> 31) ^ 1;
+
+    pow2(lhs, p->x);                      // x^2
+    pow2(rhs, p->y);                      // y^2
+    fmul(p->t, lhs, rhs);                 // x^2*y^2
+    fsub(lhs, rhs, lhs);                  // -x^2 + y^2
+    fmul(rhs, p->t, EDWARDS_D);
+    fadd(rhs, rhs, F_ONE);                // 1 + D*x^2*y^2
+    on_curve = feq(lhs, rhs);
+
+    fcopy(p->z, F_ONE);
+    fmul(p->t, p->x, p->y);               // t = x*y
+
+    WIPE_BUFFER(lhs); WIPE_BUFFER(rhs);
+
+    if ((is_canonical & on_curve) == 0){
+      #ifdef DEBUG_FLAG
+        printf("ristretto255_import_affine: Bad encoding! is_canonical=%d, on_curve=%d\n", is_canonical, on_curve);
+      #endif
+      return 1;
+    }
+    return 0;
+}
+
+
+/**
+  * @brief Initialize resumable scalar multiplication
+  * @param[in]   -> q ristretto255_point
+  * @param[in]   -> sc scalar u8[32]
+  * @param[out]  -> ctx ristretto255_scalarmult_ctx
+**/
+// Resumable (time-sliced) version of fixed-window scalar 
+// multiplication (see ristretto255_scalarmult_many). Whole state
+// (digits, window table, accumulator) lives in caller-owned ctx,
+// so the computation can be split into multiple calls of
+// ristretto255_scalarmult_step, e.g. across event-loop ticks.
+// Init recodes scalar and builds window table 
+// (1 point_double + 6 point_addition_cached).
+// *** STACKSIZE: 1x ristretto255_point = 128B + (292B+ 4size_t) ***
+void ristretto255_scalarmult_init(ristretto255_scalarmult_ctx* ctx, const ristretto255_point* q, const u8 sc[BYTES_ELEM_SIZE]){
+    ctx->digits_len = scalar_recode_radix16(ctx->digits, sc, 256);
+    ctx->next_digit = ctx->digits_len - 1;
+    window_table_build(ctx->table, q);
+
+    fcopy(ctx->acc.x,F_ZERO);
+    fcopy(ctx->acc.y,F_ONE);
+    fcopy(ctx->acc.z,F_ONE);
+    fcopy(ctx->acc.t,F_ZERO);
+}
+
+
+/**
+  * @brief Process at most max_iterations digits of scalar
+  * @param[in/out]   -> ctx ristretto255_scalarmult_ctx
+  * @param[in]       -> max_iterations upper bound of processed digits
+  * @param[out]      -> 1 if there are digits left, 0 if done
+**/
+// Every iteration performs 4 point_double, constant-time table 
+// lookup and 1 point_addition_cached, so latency of one step is
+// bounded by max_iterations and it does not depend on scalar.
+// There are 65 iterations for 256-bit scalar.
+// *** STACKSIZE: 1x ristretto255_cached_point = 128B + (292B+ 4size_t) ***
+int ristretto255_scalarmult_step(ristretto255_scalarmult_ctx* ctx, int max_iterations){
+    ristretto255_cached_point selected;
+    int i, j;
+
+    FOR(i, 0, max_iterations){
+      if (ctx->next_digit < 0){
+        break;
+      }
+      // doubling of identity is skipped, note that this does not
+      // depend on scalar
+      if (ctx->next_digit != ctx->digits_len-1){
+        FOR(j, 0, 4){
+          point_double(&ctx->acc, &ctx->acc);
+        }
+      }
+      window_table_select(&selected, ctx->table, ctx->digits[ctx->next_digit]);
+      point_addition_cached(&ctx->acc, &ctx->acc, &selected);
+      ctx->next_digit--;
+    }
+
+    WIPE_BUFFER(selected.ypx); WIPE_BUFFER(selected.ymx);
+    WIPE_BUFFER(selected.z); WIPE_BUFFER(selected.t2d);
+    return ctx->next_digit >= 0;
+}
+
+
+/**
+  * @brief Finish resumable scalar multiplication
+  * @param[in/out]   -> ctx ristretto255_scalarmult_ctx (wiped)
+  * @param[out]      -> p = sc*q ristretto255_point
+  * @param[out]      -> 0 on success, 1 if there are digits left
+**/
+// If ristretto255_scalarmult_step has not processed all digits yet,
+// p is not written. In both cases ctx is wiped, so it does not hold
+// any secret data after this call.
+// *** STACKSIZE: size_t ***
+int ristretto255_scalarmult_finish(ristretto255_scalarmult_ctx* ctx, ristretto255_point* p){
+    int unfinished = ctx->next_digit >= 0;
+
+    if (!unfinished){
+      *p = ctx->acc;
+    }
+    crypto_wipe(ctx, sizeof(*ctx));
+
+    if (unfinished){
+      #ifdef DEBUG_FLAG
+        printf("ristretto255_scalarmult_finish: scalar multiplication is not finished!\n");
+      #endif
+      return 1;
+    }
+    return 0;
+}
+
+
+/**
+  * @brief Build precomputed window table of ristretto255_point
+  * @param[in]   -> p ristretto255_point
+  * @param[out]  -> table ristretto255_table (P, 2P, ..., 8P)
+**/
+// Table can be stored (e.g. for frequently used keys or generators)
+// and reused by ristretto255_scalarmult_table, which then skips
+// table construction (1 point_double + 6 point_addition_cached).
+// *** STACKSIZE: 1x ristretto255_point = 128B + (292B+ 4size_t) ***
+void ristretto255_table_build(ristretto255_table* table, const ristretto255_point* p){
+    window_table_build(table->entry, p);
+}
+
+
+/**
+  * @brief Scalar multiplication with precomputed window table
+  * @param[in]   -> table ristretto255_table of point q
+  * @param[in]   -> sc scalar u8[32]
+  * @param[out]  -> p = sc*q ristretto255_point
+**/
+// Constant-time fixed-window multiplication (see 
+// ristretto255_scalarmult_many), table is only read.
+// *** STACKSIZE: 65B + 1x ristretto255_cached_point = 128B + (420B + 4size_t) ***
+void ristretto255_scalarmult_table(ristretto255_point* p, const ristretto255_table* table, const u8 sc[BYTES_ELEM_SIZE]){
+    signed char digits[SCALAR_DIGITS];
+
+    scalar_recode_radix16(digits, sc, 256);
+    scalarmult_window(p, table->entry, digits, SCALAR_DIGITS);
+
+    WIPE_BUFFER(digits);
+}
+
+
+/**
+  * @brief Decode input bytes u8[32] into ristretto255_handle
+  * @param[in]   -> bytes_in[32]
+  * @param[out]  -> h ristretto255_handle
+  * @param[out]  -> 0 on success, 1 on bad encoding
+**/
+// Valid encoding is canonical, so it is stored as memoized encoding
+// right away and handle is marked as validated. 
+// *** STACKSIZE: (420B + 5size_t + 3int) ***
+int ristretto255_handle_decode(ristretto255_handle* h, const u8 bytes_in[BYTES_ELEM_SIZE]){
+    int i;
+
+    if (ristretto255_decode(&h->point, bytes_in)){
+      h->has_encoding = 0;
+      h->is_validated = 0;
+      return 1;
+    }
+    COPY(i, h->encoding, bytes_in, BYTES_ELEM_SIZE);
+    h->has_encoding = 1;
+    h->is_validated = 1;
+    return 0;
+}
+
+
+/**
+  * @brief Wrap computed ristretto255_point into ristretto255_handle
+  * @param[in]   -> p ristretto255_point
+  * @param[out]  -> h ristretto255_handle
+**/
+// Encoding is computed later, on first ristretto255_handle_encode.
+// Note that if you change h->point directly, you need to call this
+// function again, so memoized encoding is dropped.
+void ristretto255_handle_set_point(ristretto255_handle* h, const ristretto255_point* p){
+    h->point = *p;
+    h->has_encoding = 0;
+    h->is_validated = 0;
+}
+
+
+/**
+  * @brief Encode ristretto255_handle to bytes u8[32]
+  * @param[in/out]   -> h ristretto255_handle
+  * @param[out]      -> bytes_out[32]
+**/
+// ristretto255_encode is performed only on first call, later calls
+// just copy memoized encoding.
+// *** STACKSIZE: (420B + 5size_t) ***
+int ristretto255_handle_encode(u8 bytes_out[BYTES_ELEM_SIZE], ristretto255_handle* h){
+    int i;
+
+    if (!h->has_encoding){
+      ristretto255_encode(h->encoding, &h->point);
+      h->has_encoding = 1;
+    }
+    COPY(i, bytes_out, h->encoding, BYTES_ELEM_SIZE);
+    return 0;
+}
+
+
+/**
+  * @brief Fill memoized encodings of array of ristretto255_handles
+  * @param[in/out]   -> h array of ristretto255_handle
+  * @param[in]       -> len number of handles
+**/
+// Handles with memoized encoding are skipped. Note that every
+// encoding still needs its own inv_sqrt, there is no shared
+// inversion (unlike ristretto255_batch_normalize).
+// *** STACKSIZE: (420B + 5size_t) ***
+void ristretto255_handle_encode_batch(ristretto255_handle h[], size_t len){
+    size_t i;
+
+    FOR(i, 0, len){
+      if (!h[i].has_encoding){
+        ristretto255_encode(h[i].encoding, &h[i].point);
+        h[i].has_encoding = 1;
+      }
+    }
+}
+
+
+/**
+  * @brief Returns 1 if two ristretto255_handles are equal
+  * @param[in]   -> p ristretto255_handle
+  * @param[in]   -> q ristretto255_handle
+  * @param[out]  -> Boolean: True/False
+**/
+// If both encodings are memoized, they are compared directly 
+// (canonical encoding is unique), otherwise we use
+// ristretto255_point_eq (4 fmul), which is cheaper than encoding.
+// *** STACKSIZE: 2x field_elem = 196B + 4size_t ***
+int ristretto255_handle_eq(const ristretto255_handle* p, const ristretto255_handle* q){
+    if (p->has_encoding && q->has_encoding){
+      return bytes_eq_32(p->encoding, q->encoding);
+    }
+    return ristretto255_point_eq(&p->point, &q->point);
+}
+
+
+// Gather point i from array of ristretto255_point_batch blocks
+// *** STACKSIZE: 3size_t ***
+static void point_batch_get(ristretto255_point* p, const ristretto255_point_batch batch[], size_t index){
+    const ristretto255_point_batch* block = &batch[index / RISTRETTO255_BATCH_LANES];
+    size_t lane = index % RISTRETTO255_BATCH_LANES;
+    size_t i;
+    FOR(i, 0, FIELED_ELEM_SIZE){
+      p->x[i] = block->x[i][lane];
+      p->y[i] = block->y[i][lane];
+      p->z[i] = block->z[i][lane];
+      p->t[i] = block->t[i][lane];
+    }
+}
+
+// Scatter point i into array of ristretto255_point_batch blocks
+// *** STACKSIZE: 3size_t ***
+static void point_batch_set(ristretto255_point_batch batch[], size_t index, const ristretto255_point* p){
+    ristretto255_point_batch* block = &batch[index / RISTRETTO255_BATCH_LANES];
+    size_t lane = index % RISTRETTO255_BATCH_LANES;
+    size_t i;
+    FOR(i, 0, FIELED_ELEM_SIZE){
+      block->x[i][lane] = p->x[i];
+      block->y[i][lane] = p->y[i];
+      block->z[i][lane] = p->z[i];
+      block->t[i][lane] = p->t[i];
+    }
+}
+
+
+/**
+  * @brief Load array of ristretto255_points into ristretto255_point_batch
+  * @param[in]   -> points array of ristretto255_point
+  * @param[in]   -> len number of points
+  * @param[out]  -> batch array of RISTRETTO255_BATCH_BLOCKS(len) ristretto255_point_batch
+**/
+void ristretto255_point_batch_load(ristretto255_point_batch batch[], const ristretto255_point points[], size_t len){
+    size_t i;
+
+    FOR(i, 0, len){
+      point_batch_set(batch, i, &points[i]);
+    }
+}
+
+
+/**
+  * @brief Store ristretto255_point_batch into array of ristretto255_points
+  * @param[in]   -> batch array of ristretto255_point_batch
+  * @param[in]   -> len number of points
+  * @param[out]  -> points array of len ristretto255_point
+**/
+void ristretto255_point_batch_store(ristretto255_point points[], const ristretto255_point_batch batch[], size_t len){
+    size_t i;
+
+    FOR(i, 0, len){
+      point_batch_get(&points[i], batch, i);
+    }
+}
+
+
+// Derivation prefix, so generators derived with our function never
+// collide with hash_to_group of other protocol messages
+static const u8 GENERATOR_DST[] = "ristretto255_derive_generators";
+
+// Absorb domain separation prefix and label into SHA-512 context,
+// label length is absorbed first, so (label, counter) pairs are
+// uniquely decodable from hashed string
+static void generator_prefix(sha512_ctx* ctx, const u8* label, size_t label_len){
+    u8 len_bytes[8];
+    int i;
+
+    FOR(i, 0, 8){
+      len_bytes[i] = (u8)((u64)label_len >> (8*i));
+    }
+    sha512_init(ctx);
+    sha512_update(ctx, GENERATOR_DST, sizeof(GENERATOR_DST) - 1);
+    sha512_update(ctx, len_bytes, 8);
+    sha512_update(ctx, label, label_len);
+}
+
+// Generator with index "index" is hash_to_point of
+// SHA-512(DST || LE64(label_len) || label || LE64(index)),
+// prefix context is already absorbed and it is only copied here
+static void generator_at(ristretto255_point* out, const sha512_ctx* prefix, u64 index){
+    sha512_ctx ctx = *prefix;
+    u8 counter[8];
+    u8 digest[HASH_BYTES_SIZE];
+    int i;
+
+    FOR(i, 0, 8){
+      counter[i] = (u8)(index >> (8*i));
+    }
+    sha512_update(&ctx, counter, 8);
+    sha512_final(&ctx, digest);
+    hash_to_point(out, digest);
+
+    WIPE_BUFFER(digest);
+}
+
+
+/**
+  * @brief Derive generators from label
+  * @param[in]   -> label, label_len domain label
+  * @param[in]   -> start index of first generator
+  * @param[in]   -> count number of generators
+  * @param[out]  -> out array of count ristretto255_point, out[i] = G_{start+i}
+**/
+// Generator G_i depends only on label and index i, so large
+// generator set can be split into ranges [start, start+count) and
+// derived by any number of workers (threads, processes), result is
+// always the same as derivation in one call. Label is hashed only
+// once per call (SHA-512 context is copied for every counter).
+// Nobody knows discrete log relation between generators, since
+// every one of them is output of hash_to_group.
+// *** STACKSIZE: 1x sha512_ctx = 208B + (64B + 1x sha512_ctx + ristretto255_ws 576B + (132B + 5size_t + 2x int)) ***
+void ristretto255_derive_generators(ristretto255_point out[], const u8* label, size_t label_len, u64 start, size_t count){
+    sha512_ctx prefix;
+    size_t i;
+
+    generator_prefix(&prefix, label, label_len);
+    FOR(i, 0, count){
+      generator_at(&out[i], &prefix, start + i);
+    }
+
+    crypto_wipe(&prefix, sizeof(prefix));
+}
+
+
+/**
+  * @brief Derive generators from label directly as precomputed tables
+  * @param[in]   -> label, label_len domain label
+  * @param[in]   -> start index of first generator
+  * @param[in]   -> count number of generators
+  * @param[out]  -> out array of count ristretto255_table of G_{start+i}
+**/
+// Same generators as ristretto255_derive_generators, but every
+// generator goes straight into ristretto255_table_build, so whole
+// array of points is never needed.
+// *** STACKSIZE: 1x sha512_ctx = 208B + 1x ristretto255_point = 128B + (64B + 1x sha512_ctx + ristretto255_ws 576B + (132B + 5size_t + 2x int)) ***
+void ristretto255_derive_generator_tables(ristretto255_table out[], const u8* label, size_t label_len, u64 start, size_t count){
+    sha512_ctx prefix;
+    ristretto255_point generator;
+    size_t i;
+
+    generator_prefix(&prefix, label, label_len);
+    FOR(i, 0, count){
+      generator_at(&generator, &prefix, start + i);
+      ristretto255_table_build(&out[i], &generator);
+    }
+
+    crypto_wipe(&prefix, sizeof(prefix)); WIPE_PT(&generator);
+}
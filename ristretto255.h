@@ -86,12 +86,49 @@
 #define _RISTRETTO255_H
 
 #include "utils.h"
+#include "sha512.h"
 
 int ristretto255_decode(ristretto255_point *ristretto_out, const u8 bytes_in[BYTES_ELEM_SIZE]);
 int ristretto255_encode(u8 bytes_out[BYTES_ELEM_SIZE], const ristretto255_point *ristretto_in);
 int hash_to_group(u8 bytes_out[BYTES_ELEM_SIZE], const u8 bytes_in[HASH_BYTES_SIZE]);
+int ristretto255_hash_to_group_xmd(u8 bytes_out[BYTES_ELEM_SIZE], const u8* msg, size_t msg_len, const u8* dst, size_t dst_len);
+int ristretto255_hash_to_group_xmd_ctx(u8 bytes_out[BYTES_ELEM_SIZE], const u8* msg, size_t msg_len, const xmd_ctx* ctx);
+int ristretto255_hash_to_group_xmd_batch(u8 bytes_out[][BYTES_ELEM_SIZE], const u8* const msgs[], const size_t msg_lens[], size_t len, const xmd_ctx* ctx);
 void ristretto255_scalarmult(ristretto255_point* p, ristretto255_point* q,const u8 *s);
 void ristretto255_point_addition(ristretto255_point* r,const ristretto255_point* p,const ristretto255_point* q);
+void ristretto255_point_addition_niels(ristretto255_point* r,const ristretto255_point* p,const ristretto255_niels_point* q);
+void ristretto255_batch_normalize(ristretto255_point* out, const ristretto255_point* in, size_t len);
+void ristretto255_batch_to_niels(ristretto255_niels_point* out, const ristretto255_point* in, size_t len);
+int ristretto255_point_eq(const ristretto255_point* p, const ristretto255_point* q);
+int ristretto255_is_identity(const ristretto255_point* p);
+int ristretto255_export_affine(u8 bytes_out[AFFINE_BYTES_SIZE], const ristretto255_point* p);
+void ristretto255_export_affine_batch(u8 bytes_out[][AFFINE_BYTES_SIZE], const ristretto255_point points[], size_t len);
+int ristretto255_import_affine(ristretto255_point* p, const u8 bytes_in[AFFINE_BYTES_SIZE]);
+void ristretto255_table_build(ristretto255_table* table, const ristretto255_point* p);
+void ristretto255_scalarmult_table(ristretto255_point* p, const ristretto255_table* table, const u8 sc[BYTES_ELEM_SIZE]);
+void ristretto255_scalarmult_init(ristretto255_scalarmult_ctx* ctx, const ristretto255_point* q, const u8 sc[BYTES_ELEM_SIZE]);
+int ristretto255_scalarmult_step(ristretto255_scalarmult_ctx* ctx, int max_iterations);
+int ristretto255_scalarmult_finish(ristretto255_scalarmult_ctx* ctx, ristretto255_point* p);
+int ristretto255_handle_decode(ristretto255_handle* h, const u8 bytes_in[BYTES_ELEM_SIZE]);
+void ristretto255_handle_set_point(ristretto255_handle* h, const ristretto255_point* p);
+int ristretto255_handle_encode(u8 bytes_out[BYTES_ELEM_SIZE], ristretto255_handle* h);
+void ristretto255_handle_encode_batch(ristretto255_handle h[], size_t len);
+int ristretto255_handle_eq(const ristretto255_handle* p, const ristretto255_handle* q);
+void ristretto255_point_batch_load(ristretto255_point_batch batch[], const ristretto255_point points[], size_t len);
+void ristretto255_point_batch_store(ristretto255_point points[], const ristretto255_point_batch batch[], size_t len);
+void ristretto255_point_sum(ristretto255_point* out, const ristretto255_point points[], size_t len);
+void ristretto255_point_sum_niels(ristretto255_point* out, const ristretto255_niels_point points[], size_t len);
+void ristretto255_scalarmult_many(ristretto255_point out[], const ristretto255_point points[], const u8 sc[BYTES_ELEM_SIZE], size_t len);
+void ristretto255_scalarmult_bits(ristretto255_point* p, const ristretto255_point* q, const u8 sc[BYTES_ELEM_SIZE], int bits);
+void ristretto255_scalarmult_batch_bits(ristretto255_point out[], const ristretto255_point points[], const u8 scalars[][BYTES_ELEM_SIZE], size_t len, int bits);
+void ristretto255_derive_generators(ristretto255_point out[], const u8* label, size_t label_len, u64 start, size_t count);
+void ristretto255_derive_generator_tables(ristretto255_table out[], const u8* label, size_t label_len, u64 start, size_t count);
+void ristretto255_ws_wipe(ristretto255_ws* ws);
+int ristretto255_decode_ws(ristretto255_point *ristretto_out, const u8 bytes_in[BYTES_ELEM_SIZE], ristretto255_ws* ws);
+int ristretto255_encode_ws(u8 bytes_out[BYTES_ELEM_SIZE], const ristretto255_point *ristretto_in, ristretto255_ws* ws);
+int hash_to_group_ws(u8 bytes_out[BYTES_ELEM_SIZE], const u8 bytes_in[HASH_BYTES_SIZE], ristretto255_ws* ws);
+void ristretto255_point_addition_ws(ristretto255_point* r,const ristretto255_point* p,const ristretto255_point* q, ristretto255_ws* ws);
+void ristretto255_scalarmult_ws(ristretto255_point* p, ristretto255_point* q,const u8 *s, ristretto255_ws* ws);
 int bytes_eq_32( const u8 a[BYTES_ELEM_SIZE],  const u8 b[BYTES_ELEM_SIZE]);
 void fneg(field_elem out, field_elem in);
 int is_neg(field_elem in);
@@ -0,0 +1,500 @@
+// ******************************************************************
+// ----------------- TECHNICAL UNIVERSITY OF KOSICE -----------------
+// ---Department of Electronics and Multimedia Telecommunications ---
+// -------- FACULTY OF ELECTRICAL ENGINEERING AND INFORMATICS -------
+// ------------ THIS CODE IS A PART OF A MASTER'S THESIS ------------
+// ------------------------- Master thesis --------------------------
+// -----------------Patrik Zelenak & Milos Drutarovsky --------------
+// ---------------------------version 0.2.1 -------------------------
+// --------------------------- 19-10-2026 ---------------------------
+// ******************************************************************
+
+/**
+  * This file contains bounded, thread-safe cache of decoded
+  * ristretto255 points with optional promotion of hot entries
+  * to precomputed window tables. See ristretto255_cache.h
+  * for more information.
+**/
+
+#include <string.h>
+#include "ristretto255_cache.h"
+
+/////////////////
+/// SipHash-2-4 /
+/////////////////
+// Keyed hash used for selection of set, so attacker is not able
+// to predict which inputs collide. Inspired by reference
+// implementation: https://github.com/veorq/SipHash
+
+#define ROTL64(x, b) (u64)(((x) << (b)) | ((x) >> (64 - (b))))
+
+#define SIPROUND(v0, v1, v2, v3)                                    \
+    do {                                                            \
+        v0 += v1; v1 = ROTL64(v1, 13); v1 ^= v0; v0 = ROTL64(v0, 32); \
+        v2 += v3; v3 = ROTL64(v3, 16); v3 ^= v2;                    \
+        v0 += v3; v3 = ROTL64(v3, 21); v3 ^= v0;                    \
+        v2 += v1; v1 = ROTL64(v1, 17); v1 ^= v2; v2 = ROTL64(v2, 32); \
+    } while (0)
+
+static u64 load64_le(const u8 in[8]){
+    u64 out = 0;
+    int i;
+    FOR(i, 0, 8){
+      out |= (u64)in[i] << (8*i);
+    }
+    return out;
+}
+
+// Note that input length is always multiple of 8 in our case
+// (BYTES_ELEM_SIZE), so we do not need to handle partial block.
+// *** STACKSIZE: 6x u64 + size_t ***
+static u64 siphash24(const u8 key[RISTRETTO255_CACHE_KEY_SIZE], const u8 *in, size_t inlen){
+    u64 k0 = load64_le(key);
+    u64 k1 = load64_le(key + 8);
+    u64 v0 = 0x736f6d6570736575ULL ^ k0;
+    u64 v1 = 0x646f72616e646f6dULL ^ k1;
+    u64 v2 = 0x6c7967656e657261ULL ^ k0;
+    u64 v3 = 0x7465646279746573ULL ^ k1;
+    u64 m;
+    size_t i;
+
+    for (i = 0; i + 8 <= inlen; i += 8){
+      m = load64_le(in + i);
+      v3 ^= m;
+      SIPROUND(v0, v1, v2, v3);
+      SIPROUND(v0, v1, v2, v3);
+      v0 ^= m;
+    }
+
+    // last block contains only length
+    m = (u64)inlen << 56;
+    v3 ^= m;
+    SIPROUND(v0, v1, v2, v3);
+    SIPROUND(v0, v1, v2, v3);
+    v0 ^= m;
+
+    v2 ^= 0xff;
+    SIPROUND(v0, v1, v2, v3);
+    SIPROUND(v0, v1, v2, v3);
+    SIPROUND(v0, v1, v2, v3);
+    SIPROUND(v0, v1, v2, v3);
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+
+/////////////////
+/// Seqlock   ///
+/////////////////
+
+// Try to lock entry (or table slot) for writing, returns 0 if it is
+// already locked by another writer (caller then simply skips the write).
+static int seq_try_lock(atomic_uint* lock, unsigned* version){
+    unsigned expected = atomic_load_explicit(lock, memory_order_relaxed);
+
+    if (expected & 1){
+      return 0;
+    }
+    if (!atomic_compare_exchange_strong_explicit(lock, &expected, expected + 1,
+                                                 memory_order_acquire, memory_order_relaxed)){
+      return 0;
+    }
+    // odd version has to be visible before any write to entry
+    atomic_thread_fence(memory_order_release);
+    *version = expected;
+    return 1;
+}
+
+static void seq_unlock(atomic_uint* lock, unsigned version){
+    atomic_store_explicit(lock, version + 2, memory_order_release);
+}
+
+// Copy payload into atomic words of entry (or table slot), relaxed
+// order is enough, since copy is ordered by version (seqlock)
+static void words_store(atomic_uint* dst, const void* src, size_t words){
+    const u8* in = (const u8*)src;
+    size_t i;
+    u32 w;
+
+    FOR(i, 0, words){
+      memcpy(&w, in + i*sizeof(u32), sizeof(u32));
+      atomic_store_explicit(&dst[i], w, memory_order_relaxed);
+    }
+}
+
+// Copy payload out of atomic words of entry (or table slot)
+static void words_load(void* dst, const atomic_uint* src, size_t words){
+    u8* out = (u8*)dst;
+    size_t i;
+    u32 w;
+
+    FOR(i, 0, words){
+      w = atomic_load_explicit(&src[i], memory_order_relaxed);
+      memcpy(out + i*sizeof(u32), &w, sizeof(u32));
+    }
+}
+
+// Compare key of entry (or table slot) with encoding
+static int key_eq(const atomic_uint key[], const u8 bytes_in[BYTES_ELEM_SIZE]){
+    u32 w, diff = 0;
+    size_t i;
+
+    FOR(i, 0, RISTRETTO255_CACHE_WORDS(u8[BYTES_ELEM_SIZE])){
+      memcpy(&w, bytes_in + i*sizeof(u32), sizeof(u32));
+      diff |= atomic_load_explicit(&key[i], memory_order_relaxed) ^ w;
+    }
+    return diff == 0;
+}
+
+static int entry_matches(const ristretto255_cache_entry* entry, const u8 bytes_in[BYTES_ELEM_SIZE]){
+    return atomic_load_explicit(&entry->is_valid, memory_order_relaxed) && key_eq(entry->key, bytes_in);
+}
+
+static int slot_matches(const ristretto255_cache_table* slot, const u8 bytes_in[BYTES_ELEM_SIZE]){
+    return atomic_load_explicit(&slot->is_valid, memory_order_relaxed) && key_eq(slot->key, bytes_in);
+}
+
+static ristretto255_cache_entry* cache_set(ristretto255_cache* cache, const u8 bytes_in[BYTES_ELEM_SIZE]){
+    u64 hash = siphash24(cache->hash_key, bytes_in, BYTES_ELEM_SIZE);
+    return cache->entries + (size_t)(hash % cache->sets) * RISTRETTO255_CACHE_WAYS;
+}
+
+
+/**
+  * @brief Lock-free lookup of encoding in cache
+  * @param[in]   -> cache
+  * @param[in]   -> bytes_in[32] encoding
+  * @param[out]  -> point decoded ristretto255_point
+  * @param[out]  -> table precomputed table (only if has_table is set), can be NULL
+  * @param[out]  -> has_table 1 if table was copied
+  * @param[out]  -> hits number of hits of entry (including this one)
+  * @param[out]  -> pointer to entry on hit, NULL on miss
+**/
+// Reader copies entry and then checks that version has not changed
+// during copying (seqlock), otherwise copy may be torn and lookup is
+// treated as miss. Fields of entry are read by relaxed atomics, so
+// read of entry which is being written is not data race, only its
+// result is never used. Table is copied from table slot of entry
+// the same way, slot may be reused by another point in the meantime,
+// so its key is checked too.
+static ristretto255_cache_entry* cache_lookup(ristretto255_cache* cache, const u8 bytes_in[BYTES_ELEM_SIZE], ristretto255_point* point, ristretto255_table* table, int* has_table, unsigned* hits){
+    ristretto255_cache_entry* set = cache_set(cache, bytes_in);
+    ristretto255_cache_table* slot;
+    size_t table_slot;
+    unsigned version;
+    int i;
+
+    FOR(i, 0, RISTRETTO255_CACHE_WAYS){
+      ristretto255_cache_entry* entry = &set[i];
+      version = atomic_load_explicit(&entry->version, memory_order_acquire);
+
+      if ((version & 1) || !entry_matches(entry, bytes_in)){
+        continue;
+      }
+      words_load(point, entry->point, RISTRETTO255_CACHE_WORDS(ristretto255_point));
+      table_slot = atomic_load_explicit(&entry->table_slot, memory_order_relaxed);
+      atomic_thread_fence(memory_order_acquire);
+      if (atomic_load_explicit(&entry->version, memory_order_relaxed) != version){
+        continue;
+      }
+
+      atomic_store_explicit(&entry->referenced, 1, memory_order_relaxed);
+      *hits = atomic_fetch_add_explicit(&entry->hits, 1, memory_order_relaxed) + 1;
+      *has_table = 0;
+      if (table != NULL && table_slot != 0){
+        slot = &cache->tables[table_slot - 1];
+        version = atomic_load_explicit(&slot->version, memory_order_acquire);
+        if (!(version & 1) && slot_matches(slot, bytes_in)){
+          words_load(table, slot->table, RISTRETTO255_CACHE_WORDS(ristretto255_table));
+          atomic_thread_fence(memory_order_acquire);
+          if (atomic_load_explicit(&slot->version, memory_order_relaxed) == version){
+            atomic_store_explicit(&slot->referenced, 1, memory_order_relaxed);
+            *has_table = 1;
+          }
+        }
+      }
+      return entry;
+    }
+    return NULL;
+}
+
+
+/**
+  * @brief Insert decoded point into cache
+  * @param[in/out]   -> cache
+  * @param[in]       -> bytes_in[32] encoding
+  * @param[in]       -> point decoded ristretto255_point
+**/
+// Victim is chosen by CLOCK inside the set: invalid entry first,
+// otherwise first entry with cleared reference bit, starting at
+// clock hand. Reference bits of passed entries are cleared, so
+// every entry gets second chance.
+// Another thread may insert the same encoding after our lookup, so
+// once victim is locked, the rest of set is checked again and write
+// is skipped if encoding is already there or another entry of set
+// is being written. Both writers lock first and check after seq_cst
+// fence, so at least one of two concurrent writers of the same
+// encoding sees the other one and set never contains duplicates.
+static void cache_insert(ristretto255_cache* cache, const u8 bytes_in[BYTES_ELEM_SIZE], const ristretto255_point* point){
+    ristretto255_cache_entry* set = cache_set(cache, bytes_in);
+    ristretto255_cache_entry* victim = NULL;
+    size_t hand = atomic_fetch_add_explicit(&cache->clock_hand, 1, memory_order_relaxed);
+    unsigned version, other;
+    int i;
+
+    FOR(i, 0, RISTRETTO255_CACHE_WAYS){
+      if (!atomic_load_explicit(&set[i].is_valid, memory_order_relaxed)){
+        victim = &set[i];
+        break;
+      }
+    }
+    // 2 rounds are enough, all reference bits are cleared in first one
+    for (i = 0; victim == NULL && i < 2*RISTRETTO255_CACHE_WAYS; i++){
+      ristretto255_cache_entry* entry = &set[(hand + i) % RISTRETTO255_CACHE_WAYS];
+      if (atomic_exchange_explicit(&entry->referenced, 0, memory_order_relaxed) == 0){
+        victim = entry;
+      }
+    }
+
+    if (victim == NULL || !seq_try_lock(&victim->version, &version)){
+      return;
+    }
+    atomic_thread_fence(memory_order_seq_cst);
+    FOR(i, 0, RISTRETTO255_CACHE_WAYS){
+      if (&set[i] == victim){
+        continue;
+      }
+      other = atomic_load_explicit(&set[i].version, memory_order_acquire);
+      if ((other & 1) || entry_matches(&set[i], bytes_in)){
+        // victim was not modified, readers only see new version
+        seq_unlock(&victim->version, version);
+        return;
+      }
+    }
+    words_store(victim->key, bytes_in, RISTRETTO255_CACHE_WORDS(u8[BYTES_ELEM_SIZE]));
+    words_store(victim->point, point, RISTRETTO255_CACHE_WORDS(ristretto255_point));
+    atomic_store_explicit(&victim->table_slot, 0, memory_order_relaxed);
+    atomic_store_explicit(&victim->is_valid, 1, memory_order_relaxed);
+    atomic_store_explicit(&victim->hits, 0, memory_order_relaxed);
+    atomic_store_explicit(&victim->referenced, 1, memory_order_relaxed);
+    seq_unlock(&victim->version, version);
+}
+
+
+#ifndef LOW_STACK_FLAG
+/**
+  * @brief Store precomputed table of hot entry into table slot
+  * @param[in/out]   -> cache
+  * @param[in/out]   -> entry cache entry of point
+  * @param[in]       -> bytes_in[32] encoding of point
+  * @param[in]       -> table precomputed table of point
+**/
+// Slot is chosen by CLOCK over all table slots (free slots have
+// cleared reference bit too). Table is written first and then slot
+// index is stored into entry, key of entry is checked again under
+// lock since entry could be evicted in the meantime.
+static void cache_store_table(ristretto255_cache* cache, ristretto255_cache_entry* entry, const u8 bytes_in[BYTES_ELEM_SIZE], const ristretto255_table* table){
+    ristretto255_cache_table* slot = NULL;
+    size_t hand = atomic_fetch_add_explicit(&cache->table_hand, 1, memory_order_relaxed);
+    size_t i, index = 0;
+    unsigned version;
+
+    for (i = 0; slot == NULL && i < 2*cache->table_capacity; i++){
+      index = (hand + i) % cache->table_capacity;
+      if (atomic_exchange_explicit(&cache->tables[index].referenced, 0, memory_order_relaxed) == 0){
+        slot = &cache->tables[index];
+      }
+    }
+    if (slot == NULL || !seq_try_lock(&slot->version, &version)){
+      return;
+    }
+    words_store(slot->key, bytes_in, RISTRETTO255_CACHE_WORDS(u8[BYTES_ELEM_SIZE]));
+    words_store(slot->table, table, RISTRETTO255_CACHE_WORDS(ristretto255_table));
+    atomic_store_explicit(&slot->is_valid, 1, memory_order_relaxed);
+    atomic_store_explicit(&slot->referenced, 1, memory_order_relaxed);
+    seq_unlock(&slot->version, version);
+
+    if (!seq_try_lock(&entry->version, &version)){
+      return;
+    }
+    if (entry_matches(entry, bytes_in)){
+      atomic_store_explicit(&entry->table_slot, index + 1, memory_order_relaxed);
+    }
+    seq_unlock(&entry->version, version);
+}
+
+/**
+  * @brief Promote hot entry to precomputed table
+  * @param[in/out]   -> cache
+  * @param[in/out]   -> entry cache entry of point
+  * @param[in]       -> bytes_in[32] encoding of point
+  * @param[in]       -> table precomputed table of point
+**/
+// Promotion of entry is claimed by promoting bit, so when several
+// threads cross promote_threshold at once, only one of them stores
+// table and the others return. Winner checks table slot of entry
+// again, since promotion could be finished by another thread after
+// our lookup.
+static void cache_promote(ristretto255_cache* cache, ristretto255_cache_entry* entry, const u8 bytes_in[BYTES_ELEM_SIZE], const ristretto255_table* table){
+    size_t table_slot;
+
+    if (atomic_exchange_explicit(&entry->promoting, 1, memory_order_acquire) != 0){
+      return;
+    }
+    table_slot = atomic_load_explicit(&entry->table_slot, memory_order_relaxed);
+    if (table_slot == 0 || !slot_matches(&cache->tables[table_slot - 1], bytes_in)){
+      cache_store_table(cache, entry, bytes_in, table);
+    }
+    atomic_store_explicit(&entry->promoting, 0, memory_order_release);
+}
+#endif
+
+
+/**
+  * @brief Initialize cache
+  * @param[out]  -> cache
+  * @param[in]   -> entries caller-provided array of entries
+  * @param[in]   -> capacity number of entries (at least RISTRETTO255_CACHE_WAYS)
+  * @param[in]   -> tables caller-provided array of table slots, can be NULL
+  * @param[in]   -> table_capacity number of table slots, 0 disables promotion
+  * @param[in]   -> hash_key[16] random secret key of SipHash
+  * @param[in]   -> promote_threshold number of hits after which entry
+  *                 gets precomputed table, 0 disables promotion
+  * @param[out]  -> 0 on success, 1 if capacity is too small
+**/
+// Note that init is not thread-safe, cache has to be initialized
+// before it is shared between threads. Both arrays are sized by
+// caller, e.g. entries[RISTRETTO255_CACHE_CAPACITY(budget, tables)]
+// and tables[tables] fit together into budget.
+int ristretto255_cache_init(ristretto255_cache* cache, ristretto255_cache_entry* entries, size_t capacity, ristretto255_cache_table* tables, size_t table_capacity, const u8 hash_key[RISTRETTO255_CACHE_KEY_SIZE], unsigned promote_threshold){
+    size_t i;
+
+    if (capacity < RISTRETTO255_CACHE_WAYS){
+      #ifdef DEBUG_FLAG
+        printf("ristretto255_cache_init: capacity=%zu is smaller than RISTRETTO255_CACHE_WAYS!\n", capacity);
+      #endif
+      return 1;
+    }
+
+    cache->entries = entries;
+    cache->sets = capacity / RISTRETTO255_CACHE_WAYS;
+    cache->tables = tables;
+    cache->table_capacity = (tables == NULL) ? 0 : table_capacity;
+    memcpy(cache->hash_key, hash_key, RISTRETTO255_CACHE_KEY_SIZE);
+    cache->promote_threshold = (cache->table_capacity == 0) ? 0 : promote_threshold;
+    atomic_init(&cache->hits, 0);
+    atomic_init(&cache->misses, 0);
+    atomic_init(&cache->clock_hand, 0);
+    atomic_init(&cache->table_hand, 0);
+
+    FOR(i, 0, cache->sets * RISTRETTO255_CACHE_WAYS){
+      atomic_init(&entries[i].version, 0);
+      atomic_init(&entries[i].referenced, 0);
+      atomic_init(&entries[i].hits, 0);
+      atomic_init(&entries[i].promoting, 0);
+      atomic_init(&entries[i].is_valid, 0);
+      atomic_init(&entries[i].table_slot, 0);
+    }
+    FOR(i, 0, cache->table_capacity){
+      atomic_init(&tables[i].version, 0);
+      atomic_init(&tables[i].referenced, 0);
+      atomic_init(&tables[i].is_valid, 0);
+    }
+    return 0;
+}
+
+
+/**
+  * @brief Decode input bytes u8[32] to ristretto255_point using cache
+  * @param[in/out]   -> cache
+  * @param[in]       -> bytes_in[32]
+  * @param[out]      -> ristretto_out ristretto255_point
+  * @param[out]      -> 0 on success, 1 on bad encoding
+**/
+// Equivalent of ristretto255_decode, on miss point is decoded and,
+// if encoding is valid, inserted into cache.
+int ristretto255_cache_decode(ristretto255_cache* cache, ristretto255_point* ristretto_out, const u8 bytes_in[BYTES_ELEM_SIZE]){
+    unsigned hits;
+    int has_table;
+
+    if (cache_lookup(cache, bytes_in, ristretto_out, NULL, &has_table, &hits) != NULL){
+      atomic_fetch_add_explicit(&cache->hits, 1, memory_order_relaxed);
+      return 0;
+    }
+
+    atomic_fetch_add_explicit(&cache->misses, 1, memory_order_relaxed);
+    if (ristretto255_decode(ristretto_out, bytes_in)){
+      return 1;
+    }
+    cache_insert(cache, bytes_in, ristretto_out);
+    return 0;
+}
+
+
+/**
+  * @brief Decode bytes u8[32] using cache and multiply by scalar
+  * @param[in/out]   -> cache
+  * @param[in]       -> bytes_in[32] encoding of point q
+  * @param[in]       -> sc scalar u8[32]
+  * @param[out]      -> p = sc*q ristretto255_point
+  * @param[out]      -> 0 on success, 1 on bad encoding
+**/
+// Once entry gets promote_threshold hits, its window table is stored
+// in table slot of cache, so later multiplications skip both
+// ristretto255_decode and table construction (see
+// ristretto255_scalarmult_table).
+// Multiplication itself is constant-time with respect to scalar.
+// In LOW_STACK_FLAG profile tables are never promoted and ladder
+// (ristretto255_scalarmult) is used, so 1KB table is not on stack.
+// *** STACKSIZE: 1x ristretto255_table = 1024B + 1x ristretto255_point = 128B + (548B + 4size_t) ***
+int ristretto255_cache_scalarmult(ristretto255_cache* cache, ristretto255_point* p, const u8 bytes_in[BYTES_ELEM_SIZE], const u8 sc[BYTES_ELEM_SIZE]){
+    ristretto255_cache_entry* entry;
+#ifndef LOW_STACK_FLAG
+    ristretto255_table table;
+#endif
+    ristretto255_point q;
+    unsigned hits = 0;
+    int has_table = 0;
+
+#ifdef LOW_STACK_FLAG
+    // no table copy on stack, only decoding is cached
+    entry = cache_lookup(cache, bytes_in, &q, NULL, &has_table, &hits);
+#else
+    entry = cache_lookup(cache, bytes_in, &q, &table, &has_table, &hits);
+#endif
+    if (entry != NULL){
+      atomic_fetch_add_explicit(&cache->hits, 1, memory_order_relaxed);
+    } else {
+      atomic_fetch_add_explicit(&cache->misses, 1, memory_order_relaxed);
+      if (ristretto255_decode(&q, bytes_in)){
+        return 1;
+      }
+      cache_insert(cache, bytes_in, &q);
+    }
+
+#ifdef LOW_STACK_FLAG
+    // q is local copy, so ladder can modify it
+    ristretto255_scalarmult(p, &q, sc);
+#else
+    if (!has_table){
+      ristretto255_table_build(&table, &q);
+      if (entry != NULL && cache->promote_threshold != 0 && hits >= cache->promote_threshold){
+        cache_promote(cache, entry, bytes_in, &table);
+      }
+    }
+
+    ristretto255_scalarmult_table(p, &table, sc);
+#endif
+    return 0;
+}
+
+
+/**
+  * @brief Returns hit/miss counters of cache
+  * @param[in]   -> cache
+  * @param[out]  -> hits
+  * @param[out]  -> misses
+**/
+void ristretto255_cache_stats(ristretto255_cache* cache, size_t* hits, size_t* misses){
+    *hits = atomic_load_explicit(&cache->hits, memory_order_relaxed);
+    *misses = atomic_load_explicit(&cache->misses, memory_order_relaxed);
+}
@@ -0,0 +1,122 @@
+// ******************************************************************
+// ----------------- TECHNICAL UNIVERSITY OF KOSICE -----------------
+// ---Department of Electronics and Multimedia Telecommunications ---
+// -------- FACULTY OF ELECTRICAL ENGINEERING AND INFORMATICS -------
+// ------------ THIS CODE IS A PART OF A MASTER'S THESIS ------------
+// ------------------------- Master thesis --------------------------
+// -----------------Patrik Zelenak & Milos Drutarovsky --------------
+// ---------------------------version 0.2.1 -------------------------
+// --------------------------- 19-10-2026 ---------------------------
+// ******************************************************************
+
+/**
+  * This file contains bounded cache of decoded ristretto255 points,
+  * keyed by their 32-byte encoding. It is meant for applications,
+  * where the same small set of (public) points, e.g. peer public
+  * keys, arrives over and over again, so we can skip
+  * ristretto255_decode (inv_sqrt) and, for hot entries, also
+  * construction of window table in scalar multiplication.
+  *
+  * Cache does not allocate any memory, caller provides array of
+  * entries and separate (usually much smaller) array of table slots,
+  * since precomputed table (1KB) is many times larger than entry
+  * and only hot entries get one. Memory budget is
+  * capacity * sizeof(ristretto255_cache_entry) +
+  * table_capacity * sizeof(ristretto255_cache_table), see macro
+  * RISTRETTO255_CACHE_CAPACITY.
+  *
+  * Entries are organized into sets of RISTRETTO255_CACHE_WAYS,
+  * set is selected by keyed hash (SipHash-2-4) of encoding, so
+  * attacker who does not know hash_key can not flood one set with
+  * colliding inputs and, since every set has fixed size, lookup
+  * always touches at most RISTRETTO255_CACHE_WAYS entries anyway.
+  * Inside set we use CLOCK (second chance) eviction, table slots
+  * are evicted by CLOCK over the whole array of slots.
+  *
+  * Cache is thread-safe, every entry is protected by sequence lock
+  * (seqlock). Readers never block, if entry is being written at the
+  * moment, lookup is simply treated as miss. Writers lock only one
+  * entry (or table slot) and if it is already locked by another
+  * writer, insertion is skipped. Insertion is also skipped if the
+  * same encoding is already in set, so set never contains duplicates.
+  * Note that C11 atomics (stdatomic.h) are required.
+  *
+  * Only valid encodings are cached, so cache hit returns exactly
+  * the same result as ristretto255_decode. Note that cache is not
+  * meant for secret points, access pattern depends on the encoding.
+**/
+
+#ifndef _RISTRETTO255_CACHE_H
+#define _RISTRETTO255_CACHE_H
+
+#include <stdatomic.h>
+#include "ristretto255.h"
+
+// number of entries in one set (associativity of cache)
+#define RISTRETTO255_CACHE_WAYS 4
+
+// size of key of SipHash-2-4 used for selection of set
+#define RISTRETTO255_CACHE_KEY_SIZE 16
+
+// number of entries that fit into memory budget (in bytes) next to
+// "tables" table slots, rounded down to whole sets, note that
+// budget has to be larger than tables * sizeof(ristretto255_cache_table)
+#define RISTRETTO255_CACHE_CAPACITY(budget, tables) \
+    ((((budget) - (tables) * sizeof(ristretto255_cache_table)) / sizeof(ristretto255_cache_entry)) \
+     / RISTRETTO255_CACHE_WAYS * RISTRETTO255_CACHE_WAYS)
+
+// number of u32 words of payload (key, point, table) of cache
+#define RISTRETTO255_CACHE_WORDS(type) (sizeof(type) / sizeof(u32))
+
+// Payload is stored in atomic words, which are copied with relaxed
+// atomics, so reader may copy entry while it is written by another
+// thread without data race (torn copy is detected by version).
+typedef struct ristretto255_cache_entry {
+    // sequence lock, odd value means that entry is being written
+    atomic_uint version;
+    // CLOCK reference bit
+    atomic_uint referenced;
+    // number of hits, used for promotion to precomputed table
+    atomic_uint hits;
+    // 1 while some thread promotes entry, so table is stored only once
+    atomic_uint promoting;
+    atomic_uint is_valid;
+    // index + 1 of table slot with table of this point, 0 = none,
+    // it is only a hint, slot is valid only if its key matches
+    atomic_size_t table_slot;
+    atomic_uint key[RISTRETTO255_CACHE_WORDS(u8[BYTES_ELEM_SIZE])];
+    atomic_uint point[RISTRETTO255_CACHE_WORDS(ristretto255_point)];
+} ristretto255_cache_entry;
+
+// slot of precomputed table of promoted (hot) entry
+typedef struct ristretto255_cache_table {
+    // sequence lock, odd value means that slot is being written
+    atomic_uint version;
+    // CLOCK reference bit
+    atomic_uint referenced;
+    atomic_uint is_valid;
+    atomic_uint key[RISTRETTO255_CACHE_WORDS(u8[BYTES_ELEM_SIZE])];
+    atomic_uint table[RISTRETTO255_CACHE_WORDS(ristretto255_table)];
+} ristretto255_cache_table;
+
+typedef struct ristretto255_cache {
+    ristretto255_cache_entry *entries;
+    size_t sets;
+    ristretto255_cache_table *tables;
+    size_t table_capacity;
+    u8 hash_key[RISTRETTO255_CACHE_KEY_SIZE];
+    unsigned promote_threshold;
+    atomic_size_t hits;
+    atomic_size_t misses;
+    // CLOCK hand, start of victim search in set
+    atomic_size_t clock_hand;
+    // CLOCK hand of table slots
+    atomic_size_t table_hand;
+} ristretto255_cache;
+
+int ristretto255_cache_init(ristretto255_cache* cache, ristretto255_cache_entry* entries, size_t capacity, ristretto255_cache_table* tables, size_t table_capacity, const u8 hash_key[RISTRETTO255_CACHE_KEY_SIZE], unsigned promote_threshold);
+int ristretto255_cache_decode(ristretto255_cache* cache, ristretto255_point* ristretto_out, const u8 bytes_in[BYTES_ELEM_SIZE]);
+int ristretto255_cache_scalarmult(ristretto255_cache* cache, ristretto255_point* p, const u8 bytes_in[BYTES_ELEM_SIZE], const u8 sc[BYTES_ELEM_SIZE]);
+void ristretto255_cache_stats(ristretto255_cache* cache, size_t* hits, size_t* misses);
+
+#endif //_RISTRETTO255_CACHE_H
@@ -0,0 +1,375 @@
+// ******************************************************************
+// ----------------- TECHNICAL UNIVERSITY OF KOSICE -----------------
+// ---Department of Electronics and Multimedia Telecommunications ---
+// -------- FACULTY OF ELECTRICAL ENGINEERING AND INFORMATICS -------
+// ------------ THIS CODE IS A PART OF A MASTER'S THESIS ------------
+// ------------------------- Master thesis --------------------------
+// -----------------Patrik Zelenak & Milos Drutarovsky --------------
+// ---------------------------version 0.2.1 -------------------------
+// --------------------------- 19-10-2026 ---------------------------
+// ******************************************************************
+
+/**
+  * This file contains fork-join thread pool and batch front-ends
+  * built on it. See ristretto255_pool.h for more information.
+**/
+
+// pthread_attr_setaffinity_np is GNU extension
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <string.h>
+#include "ristretto255_pool.h"
+#include "modl.h"
+
+#ifdef THREAD_POOL_FLAG
+// Take chunks of current batch until there is none left,
+// used by workers and by calling thread
+static void pool_work(ristretto255_pool* pool){
+    size_t start, end;
+
+    while ((start = atomic_fetch_add_explicit(&pool->next, RISTRETTO255_POOL_CHUNK, memory_order_relaxed)) < pool->len){
+      end = start + RISTRETTO255_POOL_CHUNK < pool->len ? start + RISTRETTO255_POOL_CHUNK : pool->len;
+      if (pool->task(pool->job, start, end)){
+        atomic_store_explicit(&pool->failed, 1, memory_order_relaxed);
+      }
+    }
+}
+
+// Worker waits for next generation (batch), works on it and
+// reports that it is done, until pool is stopped
+static void* pool_worker(void* arg){
+    ristretto255_pool* pool = (ristretto255_pool*)arg;
+    // generation at init, worker can start after first batch was
+    // already published, so it must not read current one
+    unsigned seen = 0;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;){
+      while (!pool->stop && pool->generation == seen){
+        pthread_cond_wait(&pool->start_cv, &pool->lock);
+      }
+      if (pool->stop){
+        break;
+      }
+      seen = pool->generation;
+      pthread_mutex_unlock(&pool->lock);
+
+      pool_work(pool);
+
+      pthread_mutex_lock(&pool->lock);
+      if (--pool->busy == 0){
+        pthread_cond_signal(&pool->done_cv);
+      }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+#endif
+
+
+/**
+  * @brief Start pool of worker threads
+  * @param[in]   -> workers number of worker threads (0 - RISTRETTO255_POOL_MAX_WORKERS),
+  *                 calling thread works too, so e.g. 3 workers use 4 cores
+  * @param[in]   -> cpus CPU of every worker (-1 = not pinned), NULL = no pinning
+  * @param[out]  -> pool
+  * @param[out]  -> 0 on success, 1 on error (pool is left without workers)
+**/
+// Affinity is supported only on Linux, elsewhere pinning fails.
+// Without THREAD_POOL_FLAG only workers = 0 is accepted.
+int ristretto255_pool_init(ristretto255_pool* pool, size_t workers, const int cpus[]){
+    memset(pool, 0, sizeof(*pool));
+    if (workers > RISTRETTO255_POOL_MAX_WORKERS){
+      #ifdef DEBUG_FLAG
+          printf("ristretto255_pool_init: Too many workers!\n");
+      #endif
+      #ifdef THREAD_POOL_FLAG
+      // nothing to destroy
+      pool->destroyed = 1;
+      #endif
+      return 1;
+    }
+#ifdef THREAD_POOL_FLAG
+    pthread_attr_t attr;
+    size_t i;
+
+    pthread_mutex_init(&pool->run_lock, NULL);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start_cv, NULL);
+    pthread_cond_init(&pool->done_cv, NULL);
+    FOR(i, 0, workers){
+      int error = pthread_attr_init(&attr);
+      if (error){
+        #ifdef DEBUG_FLAG
+            printf("ristretto255_pool_init: Can not init attributes of worker %zu!\n", i);
+        #endif
+        ristretto255_pool_destroy(pool);
+        return 1;
+      }
+      if (cpus != NULL && cpus[i] >= 0){
+        #ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpus[i], &set);
+        error = pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+        #else
+        error = 1;
+        #endif
+      }
+      if (!error){
+        error = pthread_create(&pool->threads[i], &attr, pool_worker, pool);
+      }
+      pthread_attr_destroy(&attr);
+      if (error){
+        #ifdef DEBUG_FLAG
+            printf("ristretto255_pool_init: Can not start worker %zu!\n", i);
+        #endif
+        ristretto255_pool_destroy(pool);
+        return 1;
+      }
+      pool->workers = i + 1;
+    }
+    return 0;
+#else
+    (void)cpus;
+    return workers != 0;
+#endif
+}
+
+
+/**
+  * @brief Stop and join all workers of pool
+  * @param[in/out]   -> pool
+**/
+// Destroy is idempotent, ristretto255_pool_init already destroys pool
+// on failure, so caller may still call destroy after failed init.
+void ristretto255_pool_destroy(ristretto255_pool* pool){
+#ifdef THREAD_POOL_FLAG
+    size_t i;
+
+    if (pool->destroyed){
+      return;
+    }
+    pool->destroyed = 1;
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->start_cv);
+    pthread_mutex_unlock(&pool->lock);
+    FOR(i, 0, pool->workers){
+      pthread_join(pool->threads[i], NULL);
+    }
+    pthread_cond_destroy(&pool->done_cv);
+    pthread_cond_destroy(&pool->start_cv);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_mutex_destroy(&pool->run_lock);
+#endif
+    pool->workers = 0;
+}
+
+
+/**
+  * @brief Run task on items [0, len) using workers of pool
+  * @param[in]   -> pool (NULL = run in calling thread)
+  * @param[in]   -> task function processing chunk of items
+  * @param[in]   -> job argument of task
+  * @param[in]   -> len number of items
+  * @param[out]  -> 0 if every chunk succeeded, 1 otherwise
+**/
+// Batch with at most one chunk is processed directly in calling
+// thread, waking workers would cost more than the work itself.
+int ristretto255_pool_run(ristretto255_pool* pool, ristretto255_pool_task task, void* job, size_t len){
+    if (pool == NULL || pool->workers == 0 || len <= RISTRETTO255_POOL_CHUNK){
+      return len ? task(job, 0, len) : 0;
+    }
+#ifdef THREAD_POOL_FLAG
+    int failed;
+
+    pthread_mutex_lock(&pool->run_lock);
+    pthread_mutex_lock(&pool->lock);
+    pool->task = task;
+    pool->job = job;
+    pool->len = len;
+    atomic_store_explicit(&pool->next, 0, memory_order_relaxed);
+    atomic_store_explicit(&pool->failed, 0, memory_order_relaxed);
+    pool->busy = pool->workers;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start_cv);
+    pthread_mutex_unlock(&pool->lock);
+
+    pool_work(pool);
+
+    // mutex makes outputs of workers visible to calling thread
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy != 0){
+      pthread_cond_wait(&pool->done_cv, &pool->lock);
+    }
+    failed = atomic_load_explicit(&pool->failed, memory_order_relaxed);
+    pthread_mutex_unlock(&pool->lock);
+    pthread_mutex_unlock(&pool->run_lock);
+    return failed;
+#else
+    return 1;
+#endif
+}
+
+
+//////////////////////////
+/// Batch front-ends    /
+//////////////////////////
+// Every front-end packs its arguments into job structure and runs
+// task, which processes one chunk by the sequential API. status
+// can be NULL if caller does not need per-item status.
+
+typedef struct pool_job {
+    ristretto255_point* points_out;
+    const ristretto255_point* points_in;
+    u8 (*bytes_out)[BYTES_ELEM_SIZE];
+    const u8 (*bytes_in)[BYTES_ELEM_SIZE];
+    const u8 (*hashes_in)[HASH_BYTES_SIZE];
+    int* status;
+} pool_job;
+
+// stores status of item, returns 1 if item failed
+static int pool_status(pool_job* job, size_t i, int status){
+    if (job->status != NULL){
+      job->status[i] = status;
+    }
+    return status != 0;
+}
+
+static int decode_task(void* arg, size_t start, size_t end){
+    pool_job* job = (pool_job*)arg;
+    int failed = 0;
+    size_t i;
+
+    FOR(i, start, end){
+      failed |= pool_status(job, i, ristretto255_decode(&job->points_out[i], job->bytes_in[i]));
+    }
+    return failed;
+}
+
+static int encode_task(void* arg, size_t start, size_t end){
+    pool_job* job = (pool_job*)arg;
+    int failed = 0;
+    size_t i;
+
+    FOR(i, start, end){
+      failed |= pool_status(job, i, ristretto255_encode(job->bytes_out[i], &job->points_in[i]));
+    }
+    return failed;
+}
+
+// every item is multiplied (fixed window, input point is left
+// untouched), status only reports non-canonical scalar of item
+static int scalarmult_task(void* arg, size_t start, size_t end){
+    pool_job* job = (pool_job*)arg;
+    ristretto255_scalar canonical;
+    int failed = 0;
+    size_t i;
+
+    FOR(i, start, end){
+      ristretto255_scalarmult_bits(&job->points_out[i], &job->points_in[i], job->bytes_in[i], 256);
+      failed |= pool_status(job, i, ristretto255_scalar_decode(&canonical, job->bytes_in[i]));
+    }
+    return failed;
+}
+
+// items of chunk share one workspace, which is wiped once per chunk
+static int hash_to_group_task(void* arg, size_t start, size_t end){
+    pool_job* job = (pool_job*)arg;
+    ristretto255_ws ws;
+    int failed = 0;
+    size_t i;
+
+    FOR(i, start, end){
+      failed |= pool_status(job, i, hash_to_group_ws(job->bytes_out[i], job->hashes_in[i], &ws));
+    }
+    ristretto255_ws_wipe(&ws);
+    return failed;
+}
+
+
+/**
+  * @brief Decode array of encodings using pool
+  * @param[in]   -> pool (NULL = sequential)
+  * @param[in]   -> bytes_in array of len u8[32]
+  * @param[in]   -> len
+  * @param[out]  -> out array of len ristretto255_point
+  * @param[out]  -> status array of len, status[i] = ristretto255_decode result (can be NULL)
+  * @param[out]  -> 0 if all items were decoded, 1 otherwise
+**/
+int ristretto255_pool_decode(ristretto255_pool* pool, ristretto255_point out[], const u8 bytes_in[][BYTES_ELEM_SIZE], int status[], size_t len){
+    pool_job job = {0};
+
+    job.points_out = out;
+    job.bytes_in = bytes_in;
+    job.status = status;
+    return ristretto255_pool_run(pool, decode_task, &job, len);
+}
+
+
+/**
+  * @brief Encode array of points using pool
+  * @param[in]   -> pool (NULL = sequential)
+  * @param[in]   -> points array of len ristretto255_point
+  * @param[in]   -> len
+  * @param[out]  -> bytes_out array of len u8[32]
+  * @param[out]  -> status array of len, status[i] = ristretto255_encode result (can be NULL)
+  * @param[out]  -> 0 if all items were encoded, 1 otherwise
+**/
+int ristretto255_pool_encode(ristretto255_pool* pool, u8 bytes_out[][BYTES_ELEM_SIZE], const ristretto255_point points[], int status[], size_t len){
+    pool_job job = {0};
+
+    job.bytes_out = bytes_out;
+    job.points_in = points;
+    job.status = status;
+    return ristretto255_pool_run(pool, encode_task, &job, len);
+}
+
+
+/**
+  * @brief Independent scalar multiplications using pool
+  * @param[in]   -> pool (NULL = sequential)
+  * @param[in]   -> points array of len ristretto255_point (left untouched)
+  * @param[in]   -> scalars array of len scalars u8[32]
+  * @param[in]   -> len
+  * @param[out]  -> out array of len ristretto255_point, out[i] = scalars[i]*points[i]
+  * @param[out]  -> status array of len, status[i] = 1 if scalars[i] is not
+  *                 canonical (>= L), see ristretto255_scalar_decode (can be NULL)
+  * @param[out]  -> 0 if all scalars are canonical, 1 otherwise
+**/
+// Same results as ristretto255_scalarmult, every item is processed
+// in constant time with respect to its scalar. Multiplication itself
+// can not fail, out[i] is computed for non-canonical scalar too
+// (multiplication is modulo group order anyway), status only tells
+// caller which scalars were not reduced.
+int ristretto255_pool_scalarmult(ristretto255_pool* pool, ristretto255_point out[], const ristretto255_point points[], const u8 scalars[][BYTES_ELEM_SIZE], int status[], size_t len){
+    pool_job job = {0};
+
+    job.points_out = out;
+    job.points_in = points;
+    job.bytes_in = scalars;
+    job.status = status;
+    return ristretto255_pool_run(pool, scalarmult_task, &job, len);
+}
+
+
+/**
+  * @brief hash_to_group of array of hashes using pool
+  * @param[in]   -> pool (NULL = sequential)
+  * @param[in]   -> bytes_in array of len u8[64]
+  * @param[in]   -> len
+  * @param[out]  -> bytes_out array of len u8[32]
+  * @param[out]  -> status array of len, status[i] = hash_to_group result (can be NULL)
+  * @param[out]  -> 0 if all items succeeded, 1 otherwise
+**/
+int ristretto255_pool_hash_to_group(ristretto255_pool* pool, u8 bytes_out[][BYTES_ELEM_SIZE], const u8 bytes_in[][HASH_BYTES_SIZE], int status[], size_t len){
+    pool_job job = {0};
+
+    job.bytes_out = bytes_out;
+    job.hashes_in = bytes_in;
+    job.status = status;
+    return ristretto255_pool_run(pool, hash_to_group_task, &job, len);
+}
@@ -0,0 +1,85 @@
+// ******************************************************************
+// ----------------- TECHNICAL UNIVERSITY OF KOSICE -----------------
+// ---Department of Electronics and Multimedia Telecommunications ---
+// -------- FACULTY OF ELECTRICAL ENGINEERING AND INFORMATICS -------
+// ------------ THIS CODE IS A PART OF A MASTER'S THESIS ------------
+// ------------------------- Master thesis --------------------------
+// -----------------Patrik Zelenak & Milos Drutarovsky --------------
+// ---------------------------version 0.2.1 -------------------------
+// --------------------------- 19-10-2026 ---------------------------
+// ******************************************************************
+
+/**
+  * This file contains small fork-join thread pool and batch
+  * front-ends of ristretto255_decode, ristretto255_encode, scalar
+  * multiplication and hash_to_group, which split array of inputs
+  * across workers.
+  *
+  * Items are processed in chunks of RISTRETTO255_POOL_CHUNK, workers
+  * (and calling thread, which works too) take next chunk from shared
+  * atomic counter, so faster cores simply process more chunks.
+  * Every item writes only its own output and status, so result order
+  * is the same as order of inputs and results are identical to
+  * sequential calls.
+  *
+  * Pool does not allocate any memory, worker threads are stored in
+  * ristretto255_pool (at most RISTRETTO255_POOL_MAX_WORKERS). One
+  * pool runs one batch at a time, concurrent batch calls on the same
+  * pool wait for each other.
+  *
+  * Threads (POSIX) are used only with THREAD_POOL_FLAG (see config.h),
+  * without it, or with pool NULL or with 0 workers, batch functions
+  * run sequentially in calling thread, so the same code works on MCU.
+**/
+
+#ifndef _RISTRETTO255_POOL_H
+#define _RISTRETTO255_POOL_H
+
+#include "ristretto255.h"
+
+#ifdef THREAD_POOL_FLAG
+#include <pthread.h>
+#include <stdatomic.h>
+#endif
+
+#define RISTRETTO255_POOL_MAX_WORKERS 64
+// number of items taken by worker at once
+#define RISTRETTO255_POOL_CHUNK 8
+
+// processes items [start, end) of job, returns 1 if some item failed
+typedef int (*ristretto255_pool_task)(void* job, size_t start, size_t end);
+
+typedef struct ristretto255_pool {
+    size_t workers;
+#ifdef THREAD_POOL_FLAG
+    pthread_t threads[RISTRETTO255_POOL_MAX_WORKERS];
+    // serializes batches of the same pool
+    pthread_mutex_t run_lock;
+    pthread_mutex_t lock;
+    pthread_cond_t start_cv;
+    pthread_cond_t done_cv;
+    // current batch, generation is incremented for every batch
+    ristretto255_pool_task task;
+    void* job;
+    size_t len;
+    atomic_size_t next;
+    atomic_int failed;
+    unsigned generation;
+    // number of workers which did not finish current batch yet
+    size_t busy;
+    int stop;
+    // set by ristretto255_pool_destroy, so second destroy does nothing
+    int destroyed;
+#endif
+} ristretto255_pool;
+
+int ristretto255_pool_init(ristretto255_pool* pool, size_t workers, const int cpus[]);
+void ristretto255_pool_destroy(ristretto255_pool* pool);
+int ristretto255_pool_run(ristretto255_pool* pool, ristretto255_pool_task task, void* job, size_t len);
+
+int ristretto255_pool_decode(ristretto255_pool* pool, ristretto255_point out[], const u8 bytes_in[][BYTES_ELEM_SIZE], int status[], size_t len);
+int ristretto255_pool_encode(ristretto255_pool* pool, u8 bytes_out[][BYTES_ELEM_SIZE], const ristretto255_point points[], int status[], size_t len);
+int ristretto255_pool_scalarmult(ristretto255_pool* pool, ristretto255_point out[], const ristretto255_point points[], const u8 scalars[][BYTES_ELEM_SIZE], int status[], size_t len);
+int ristretto255_pool_hash_to_group(ristretto255_pool* pool, u8 bytes_out[][BYTES_ELEM_SIZE], const u8 bytes_in[][HASH_BYTES_SIZE], int status[], size_t len);
+
+#endif //_RISTRETTO255_POOL_H
@@ -0,0 +1,202 @@
+// ******************************************************************
+// ----------------- TECHNICAL UNIVERSITY OF KOSICE -----------------
+// ---Department of Electronics and Multimedia Telecommunications ---
+// -------- FACULTY OF ELECTRICAL ENGINEERING AND INFORMATICS -------
+// ------------ THIS CODE IS A PART OF A MASTER'S THESIS ------------
+// ------------------------- Master thesis --------------------------
+// -----------------Patrik Zelenak & Milos Drutarovsky --------------
+// ---------------------------version 0.2.1 -------------------------
+// --------------------------- 19-10-2026 ---------------------------
+// ******************************************************************
+
+/**
+  * This file contains writer (header) and zero-copy loader of
+  * precomputed table files. See ristretto255_table_file.h
+  * for more information.
+**/
+
+#include <string.h>
+#include <stdint.h>
+#include "ristretto255_table_file.h"
+
+#ifdef TABLE_FILE_MMAP_FLAG
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+static const u8 TABLE_FILE_MAGIC[8] = {'R', '2', '5', '5', 'T', 'B', 'L', 0};
+
+static void store_le(u8* out, u64 in, int len){
+    int i;
+    FOR(i, 0, len){
+      out[i] = (u8)(in >> (8*i));
+    }
+}
+
+static u64 load_le(const u8* in, int len){
+    u64 out = 0;
+    int i;
+    FOR(i, 0, len){
+      out |= (u64)in[i] << (8*i);
+    }
+    return out;
+}
+
+// checksum = SHA-512(header[0..31] || tables), truncated to 32B
+// *** STACKSIZE: 1x sha512_ctx = 208B + 64B + (8B + 640B + 10x u64) ***
+static void table_file_checksum(u8 out[BYTES_ELEM_SIZE], const u8 header[RISTRETTO255_TABLE_FILE_HEADER_SIZE], const void* tables, size_t tables_len){
+    sha512_ctx ctx;
+    u8 digest[HASH_BYTES_SIZE];
+
+    sha512_init(&ctx);
+    sha512_update(&ctx, header, 32);
+    sha512_update(&ctx, (const u8*)tables, tables_len);
+    sha512_final(&ctx, digest);
+    memcpy(out, digest, BYTES_ELEM_SIZE);
+}
+
+
+/**
+  * @brief Make header of table file
+  * @param[in]   -> tables array of count ristretto255_table
+  * @param[in]   -> count
+  * @param[in]   -> tag user-defined type of tables
+  * @param[out]  -> header u8[64], file is header followed by tables
+  * @param[out]  -> 0 on success, 1 if count is too large
+**/
+// Writer (e.g. table_gen) writes header and then tables exactly as
+// they are in memory: fwrite(tables, sizeof(ristretto255_table), count, f)
+// *** STACKSIZE: 1x u32 + (1x sha512_ctx + 64B + (8B + 640B + 10x u64)) ***
+int ristretto255_table_file_header(u8 header[RISTRETTO255_TABLE_FILE_HEADER_SIZE], const ristretto255_table tables[], size_t count, u32 tag){
+    u32 order = RISTRETTO255_TABLE_FILE_ORDER;
+
+    if (count > (SIZE_MAX - RISTRETTO255_TABLE_FILE_HEADER_SIZE) / sizeof(ristretto255_table)){
+      #ifdef DEBUG_FLAG
+          printf("ristretto255_table_file_header: Too many tables!\n");
+      #endif
+      return 1;
+    }
+    memset(header, 0, RISTRETTO255_TABLE_FILE_HEADER_SIZE);
+    memcpy(header, TABLE_FILE_MAGIC, 8);
+    store_le(header + 8, RISTRETTO255_TABLE_FILE_VERSION, 4);
+    store_le(header + 12, sizeof(ristretto255_table), 4);
+    memcpy(header + 16, &order, 4);
+    store_le(header + 20, tag, 4);
+    store_le(header + 24, count, 8);
+    table_file_checksum(header + 32, header, tables, count * sizeof(ristretto255_table));
+    return 0;
+}
+
+
+/**
+  * @brief Check table file in memory and point to its tables (no copy)
+  * @param[in]   -> data content of file, aligned at least as ristretto255_table
+  * @param[in]   -> len length of data
+  * @param[out]  -> file tables, count and tag, file->tables points into data
+  * @param[out]  -> 0 on success, 1 on bad/corrupted file
+**/
+// Checks magic, version, table size, byte order, length and
+// checksum, so all pages of file are read once during load.
+// data has to stay valid (mapped) while tables are used.
+// *** STACKSIZE: 32B + 1x u32 + (1x sha512_ctx + 64B + (8B + 640B + 10x u64)) ***
+int ristretto255_table_file_parse(ristretto255_table_file* file, const void* data, size_t len){
+    const u8* bytes = (const u8*)data;
+    u8 checksum[BYTES_ELEM_SIZE];
+    u32 order;
+    u64 count;
+
+    memset(file, 0, sizeof(*file));
+    if (len < RISTRETTO255_TABLE_FILE_HEADER_SIZE || ((uintptr_t)data % _Alignof(ristretto255_table)) != 0){
+      #ifdef DEBUG_FLAG
+          printf("ristretto255_table_file_parse: File is too short or unaligned!\n");
+      #endif
+      return 1;
+    }
+    memcpy(&order, bytes + 16, 4);
+    count = load_le(bytes + 24, 8);
+    if (memcmp(bytes, TABLE_FILE_MAGIC, 8) != 0
+        || load_le(bytes + 8, 4) != RISTRETTO255_TABLE_FILE_VERSION
+        || load_le(bytes + 12, 4) != sizeof(ristretto255_table)
+        || order != RISTRETTO255_TABLE_FILE_ORDER
+        || (len - RISTRETTO255_TABLE_FILE_HEADER_SIZE) % sizeof(ristretto255_table) != 0
+        || count != (len - RISTRETTO255_TABLE_FILE_HEADER_SIZE) / sizeof(ristretto255_table)){
+      #ifdef DEBUG_FLAG
+          printf("ristretto255_table_file_parse: Bad header (magic, version, table size, byte order or length)!\n");
+      #endif
+      return 1;
+    }
+    table_file_checksum(checksum, bytes, bytes + RISTRETTO255_TABLE_FILE_HEADER_SIZE, len - RISTRETTO255_TABLE_FILE_HEADER_SIZE);
+    if (!bytes_eq_32(checksum, bytes + 32)){
+      #ifdef DEBUG_FLAG
+          printf("ristretto255_table_file_parse: Checksum does not match!\n");
+      #endif
+      return 1;
+    }
+
+    file->tables = (const ristretto255_table*)(bytes + RISTRETTO255_TABLE_FILE_HEADER_SIZE);
+    file->count = (size_t)count;
+    file->tag = (u32)load_le(bytes + 20, 4);
+    return 0;
+}
+
+
+#ifdef TABLE_FILE_MMAP_FLAG
+/**
+  * @brief Map table file read-only into memory and check it
+  * @param[in]   -> path
+  * @param[out]  -> file mapped tables, release with ristretto255_table_file_unmap
+  * @param[out]  -> 0 on success, 1 on error (file is left empty)
+**/
+// File is mapped with MAP_SHARED and PROT_READ, so all processes
+// (e.g. forked workers) that map the same file share one copy of
+// tables in page cache and loading costs only checksum.
+// *** STACKSIZE: 1x struct stat + (ristretto255_table_file_parse) ***
+int ristretto255_table_file_map(ristretto255_table_file* file, const char* path){
+    struct stat st;
+    void* map;
+    int fd;
+
+    memset(file, 0, sizeof(*file));
+    fd = open(path, O_RDONLY);
+    if (fd < 0){
+      #ifdef DEBUG_FLAG
+          printf("ristretto255_table_file_map: Can not open %s!\n", path);
+      #endif
+      return 1;
+    }
+    if (fstat(fd, &st) != 0 || st.st_size < RISTRETTO255_TABLE_FILE_HEADER_SIZE){
+      close(fd);
+      return 1;
+    }
+    map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    // mapping stays valid after close
+    close(fd);
+    if (map == MAP_FAILED){
+      #ifdef DEBUG_FLAG
+          printf("ristretto255_table_file_map: mmap of %s failed!\n", path);
+      #endif
+      return 1;
+    }
+    if (ristretto255_table_file_parse(file, map, (size_t)st.st_size)){
+      munmap(map, (size_t)st.st_size);
+      return 1;
+    }
+    file->map = map;
+    file->map_len = (size_t)st.st_size;
+    return 0;
+}
+
+
+/**
+  * @brief Unmap table file opened by ristretto255_table_file_map
+  * @param[in/out]   -> file
+**/
+void ristretto255_table_file_unmap(ristretto255_table_file* file){
+    if (file->map != NULL){
+      munmap(file->map, file->map_len);
+    }
+    memset(file, 0, sizeof(*file));
+}
+#endif
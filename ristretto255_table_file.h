@@ -0,0 +1,70 @@
+// ******************************************************************
+// ----------------- TECHNICAL UNIVERSITY OF KOSICE -----------------
+// ---Department of Electronics and Multimedia Telecommunications ---
+// -------- FACULTY OF ELECTRICAL ENGINEERING AND INFORMATICS -------
+// ------------ THIS CODE IS A PART OF A MASTER'S THESIS ------------
+// ------------------------- Master thesis --------------------------
+// -----------------Patrik Zelenak & Milos Drutarovsky --------------
+// ---------------------------version 0.2.1 -------------------------
+// --------------------------- 19-10-2026 ---------------------------
+// ******************************************************************
+
+/**
+  * This file contains binary file format of precomputed window
+  * tables (ristretto255_table), so tables can be built once (e.g. by
+  * `make table_gen`, see table_gen.c) and then used directly from
+  * memory without any copying, every process that maps the same file
+  * (ristretto255_table_file_map) shares the same read-only pages.
+  * On MCU the same file can be placed into flash and used by
+  * ristretto255_table_file_parse.
+  *
+  * Layout of file (header is 64B, so tables stay aligned):
+  *   0  magic "R255TBL" + 0
+  *   8  format version (u32, little-endian)
+  *  12  size of one table in bytes (u32, little-endian)
+  *  16  RISTRETTO255_TABLE_FILE_ORDER in native byte order
+  *  20  tag (u32, little-endian), e.g. RISTRETTO255_TABLE_FILE_GENERATORS
+  *  24  number of tables (u64, little-endian)
+  *  32  checksum, first 32B of SHA-512(bytes 0..31 || tables)
+  *  64  tables, as ristretto255_table in native layout
+  *
+  * Tables are stored in native layout of field_elem (u32 limbs),
+  * so file is bound to byte order and size of ristretto255_table
+  * of the machine, which are both checked on load. Checksum detects
+  * corrupted or truncated file, it is not a signature, so file has
+  * to come from trusted source (points in tables are not validated).
+**/
+
+#ifndef _RISTRETTO255_TABLE_FILE_H
+#define _RISTRETTO255_TABLE_FILE_H
+
+#include "ristretto255.h"
+
+#define RISTRETTO255_TABLE_FILE_HEADER_SIZE 64
+#define RISTRETTO255_TABLE_FILE_VERSION 1
+// written in native byte order, loader on machine with different
+// byte order reads different value
+#define RISTRETTO255_TABLE_FILE_ORDER 0x01020304u
+
+// tags used by table_gen, tag is not interpreted by library
+#define RISTRETTO255_TABLE_FILE_GENERATORS 1
+#define RISTRETTO255_TABLE_FILE_POINTS 2
+
+typedef struct ristretto255_table_file {
+    // tables inside of mapped (or parsed) memory, read-only
+    const ristretto255_table* tables;
+    size_t count;
+    u32 tag;
+    // mapping, only if opened by ristretto255_table_file_map
+    void* map;
+    size_t map_len;
+} ristretto255_table_file;
+
+int ristretto255_table_file_header(u8 header[RISTRETTO255_TABLE_FILE_HEADER_SIZE], const ristretto255_table tables[], size_t count, u32 tag);
+int ristretto255_table_file_parse(ristretto255_table_file* file, const void* data, size_t len);
+#ifdef TABLE_FILE_MMAP_FLAG
+int ristretto255_table_file_map(ristretto255_table_file* file, const char* path);
+void ristretto255_table_file_unmap(ristretto255_table_file* file);
+#endif
+
+#endif //_RISTRETTO255_TABLE_FILE_H
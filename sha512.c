@@ -0,0 +1,298 @@
+// ******************************************************************
+// ----------------- TECHNICAL UNIVERSITY OF KOSICE -----------------
+// ---Department of Electronics and Multimedia Telecommunications ---
+// -------- FACULTY OF ELECTRICAL ENGINEERING AND INFORMATICS -------
+// ------------ THIS CODE IS A PART OF A MASTER'S THESIS ------------
+// ------------------------- Master thesis --------------------------
+// -----------------Patrik Zelenak & Milos Drutarovsky --------------
+// ---------------------------version 0.2.1 -------------------------
+// --------------------------- 19-10-2026 ---------------------------
+// ******************************************************************
+
+/**
+  * This file contains compact implementation of SHA-512
+  * (FIPS 180-4). See sha512.h for more information.
+**/
+
+#include "sha512.h"
+#include "utils.h"
+
+static const u64 K[80] = {
+    0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+    0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+    0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+    0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+    0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+    0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+    0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+    0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+    0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+    0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+    0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+    0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+    0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+    0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+    0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+    0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+    0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+    0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+    0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+    0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL,
+};
+
+#define ROTR64(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+#define CH(x, y, z)  (((x) & (y)) ^ (~(x) & (z)))
+#define MAJ(x, y, z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define BSIG0(x) (ROTR64(x, 28) ^ ROTR64(x, 34) ^ ROTR64(x, 39))
+#define BSIG1(x) (ROTR64(x, 14) ^ ROTR64(x, 18) ^ ROTR64(x, 41))
+#define SSIG0(x) (ROTR64(x,  1) ^ ROTR64(x,  8) ^ ((x) >> 7))
+#define SSIG1(x) (ROTR64(x, 19) ^ ROTR64(x, 61) ^ ((x) >> 6))
+
+static u64 load64_be(const u8 in[8]){
+    u64 out = 0;
+    int i;
+    FOR(i, 0, 8){
+      out = (out << 8) | in[i];
+    }
+    return out;
+}
+
+static void store64_be(u8 out[8], u64 in){
+    int i;
+    FOR(i, 0, 8){
+      out[7-i] = (u8)(in >> (8*i));
+    }
+}
+
+// Compression of one 128B block, in LOW_STACK_FLAG profile
+// message schedule is computed in place in 16 words (rolling
+// window w[i mod 16]) instead of all 80 words
+#ifdef LOW_STACK_FLAG
+#define SHA512_SCHEDULE_WORDS 16
+#else
+#define SHA512_SCHEDULE_WORDS 80
+#endif
+// *** STACKSIZE: 80x u64 = 640B (16x u64 = 128B) + 10x u64 ***
+static void sha512_compress(u64 hash[8], const u8 block[SHA512_BLOCK_SIZE]){
+    u64 w[SHA512_SCHEDULE_WORDS];
+    u64 state[8];
+    u64 temp1, temp2;
+    int i;
+
+    FOR(i, 0, 16){
+      w[i] = load64_be(block + 8*i);
+    }
+#ifndef LOW_STACK_FLAG
+    FOR(i, 16, 80){
+      w[i] = SSIG1(w[i-2]) + w[i-7] + SSIG0(w[i-15]) + w[i-16];
+    }
+#endif
+    COPY(i, state, hash, 8);
+
+    FOR(i, 0, 80){
+#ifdef LOW_STACK_FLAG
+      if (i >= 16){
+        w[i&15] += SSIG1(w[(i-2)&15]) + w[(i-7)&15] + SSIG0(w[(i-15)&15]);
+      }
+      temp1 = state[7] + BSIG1(state[4]) + CH(state[4], state[5], state[6]) + K[i] + w[i&15];
+#else
+      temp1 = state[7] + BSIG1(state[4]) + CH(state[4], state[5], state[6]) + K[i] + w[i];
+#endif
+      temp2 = BSIG0(state[0]) + MAJ(state[0], state[1], state[2]);
+      state[7] = state[6];
+      state[6] = state[5];
+      state[5] = state[4];
+      state[4] = state[3] + temp1;
+      state[3] = state[2];
+      state[2] = state[1];
+      state[1] = state[0];
+      state[0] = temp1 + temp2;
+    }
+
+    FOR(i, 0, 8){
+      hash[i] += state[i];
+    }
+
+    WIPE_BUFFER(w); WIPE_BUFFER(state);
+}
+
+
+/**
+  * @brief Initialize SHA-512 context
+  * @param[out]  -> ctx sha512_ctx
+**/
+void sha512_init(sha512_ctx* ctx){
+    static const u64 iv[8] = {
+        0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+        0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL,
+    };
+    int i;
+
+    COPY(i, ctx->hash, iv, 8);
+    ctx->block_len = 0;
+    ctx->total_len = 0;
+}
+
+
+/**
+  * @brief Absorb message into SHA-512 context
+  * @param[in/out]   -> ctx sha512_ctx
+  * @param[in]       -> message
+  * @param[in]       -> message_len
+**/
+void sha512_update(sha512_ctx* ctx, const u8* message, size_t message_len){
+    ctx->total_len += message_len;
+    while (message_len > 0){
+      size_t chunk = SHA512_BLOCK_SIZE - ctx->block_len;
+      size_t i;
+
+      if (chunk > message_len){
+        chunk = message_len;
+      }
+      COPY(i, ctx->block + ctx->block_len, message, chunk);
+      ctx->block_len += chunk;
+      message += chunk;
+      message_len -= chunk;
+
+      if (ctx->block_len == SHA512_BLOCK_SIZE){
+        sha512_compress(ctx->hash, ctx->block);
+        ctx->block_len = 0;
+      }
+    }
+}
+
+
+/**
+  * @brief Finish SHA-512 computation
+  * @param[in/out]   -> ctx sha512_ctx (wiped)
+  * @param[out]      -> hash[64]
+**/
+// Padding: 0x80, zeros and 128-bit big-endian length in bits
+// (upper 64 bits are always 0 in our case).
+void sha512_final(sha512_ctx* ctx, u8 hash[HASH_BYTES_SIZE]){
+    u64 bit_len = ctx->total_len << 3;
+    size_t i;
+
+    ctx->block[ctx->block_len++] = 0x80;
+    if (ctx->block_len > SHA512_BLOCK_SIZE - 16){
+      ZERO(i, ctx->block + ctx->block_len, SHA512_BLOCK_SIZE - ctx->block_len);
+      sha512_compress(ctx->hash, ctx->block);
+      ctx->block_len = 0;
+    }
+    ZERO(i, ctx->block + ctx->block_len, SHA512_BLOCK_SIZE - 8 - ctx->block_len);
+    store64_be(ctx->block + SHA512_BLOCK_SIZE - 8, bit_len);
+    sha512_compress(ctx->hash, ctx->block);
+
+    FOR(i, 0, 8){
+      store64_be(hash + 8*i, ctx->hash[i]);
+    }
+    crypto_wipe(ctx, sizeof(*ctx));
+}
+
+
+/**
+  * @brief One-shot SHA-512
+  * @param[in]   -> message
+  * @param[in]   -> message_len
+  * @param[out]  -> hash[64]
+**/
+void sha512(u8 hash[HASH_BYTES_SIZE], const u8* message, size_t message_len){
+    sha512_ctx ctx;
+    sha512_init(&ctx);
+    sha512_update(&ctx, message, message_len);
+    sha512_final(&ctx, hash);
+}
+
+
+/**
+  * @brief Precompute message independent part of expand_message_xmd
+  * @param[in]   -> dst, dst_len domain separation tag
+  * @param[out]  -> ctx xmd_ctx
+**/
+// DST longer than 255B is replaced by 
+// SHA-512("H2C-OVERSIZE-DST-" || DST) as in RFC 9380, 5.3.3
+void xmd_init(xmd_ctx* ctx, const u8* dst, size_t dst_len){
+    static const u8 oversize_prefix[] = "H2C-OVERSIZE-DST-";
+    u8 zero_block[SHA512_BLOCK_SIZE] = {0};
+    size_t i;
+
+    if (dst_len > XMD_MAX_DST_SIZE){
+      sha512_init(&ctx->zpad_state);
+      sha512_update(&ctx->zpad_state, oversize_prefix, sizeof(oversize_prefix) - 1);
+      sha512_update(&ctx->zpad_state, dst, dst_len);
+      sha512_final(&ctx->zpad_state, ctx->dst_prime);
+      dst_len = HASH_BYTES_SIZE;
+    }
+    else{
+      COPY(i, ctx->dst_prime, dst, dst_len);
+    }
+    ctx->dst_prime[dst_len] = (u8)dst_len;
+    ctx->dst_prime_len = dst_len + 1;
+
+    sha512_init(&ctx->zpad_state);
+    sha512_update(&ctx->zpad_state, zero_block, SHA512_BLOCK_SIZE);
+}
+
+
+/**
+  * @brief expand_message_xmd from RFC 9380 with SHA-512
+  * @param[in]   -> message, message_len
+  * @param[in]   -> ctx xmd_ctx from xmd_init
+  * @param[in]   -> out_len length of output (at most XMD_MAX_OUT_SIZE)
+  * @param[out]  -> out[out_len] uniform bytes
+  * @return 0 on success, 1 if out_len is out of range
+**/
+// b_0 = H(Z_pad || msg || I2OSP(len, 2) || I2OSP(0, 1) || DST_prime)
+// b_1 = H(b_0 || I2OSP(1, 1) || DST_prime)
+// b_i = H((b_0 XOR b_(i-1)) || I2OSP(i, 1) || DST_prime)
+// Z_pad is already absorbed in ctx->zpad_state, so b_0 costs one 
+// compression less.
+// *** STACKSIZE: 1x sha512_ctx = 208B + 3x 64B + (208B + 640B + 10x u64) ***
+int expand_message_xmd(u8* out, size_t out_len, const u8* message, size_t message_len, const xmd_ctx* ctx){
+    sha512_ctx hash_ctx;
+    u8 b_0[HASH_BYTES_SIZE];
+    u8 b_i[HASH_BYTES_SIZE];
+    u8 block_info[3];
+    size_t ell, i, j, chunk;
+
+    if (out_len == 0 || out_len > XMD_MAX_OUT_SIZE){
+      #ifdef DEBUG_FLAG
+          printf("expand_message_xmd: invalid output length %zu\n", out_len);
+      #endif
+      return 1;
+    }
+    ell = (out_len + HASH_BYTES_SIZE - 1) / HASH_BYTES_SIZE;
+
+    // I2OSP(len_in_bytes, 2) || I2OSP(0, 1)
+    block_info[0] = (u8)(out_len >> 8);
+    block_info[1] = (u8)out_len;
+    block_info[2] = 0;
+
+    hash_ctx = ctx->zpad_state;
+    sha512_update(&hash_ctx, message, message_len);
+    sha512_update(&hash_ctx, block_info, 3);
+    sha512_update(&hash_ctx, ctx->dst_prime, ctx->dst_prime_len);
+    sha512_final(&hash_ctx, b_0);
+
+    ZERO(j, b_i, HASH_BYTES_SIZE);
+    FOR(i, 1, ell + 1){
+      // b_0 XOR b_(i-1), b_i is zero for i = 1
+      FOR(j, 0, HASH_BYTES_SIZE){
+        b_i[j] ^= b_0[j];
+      }
+      block_info[0] = (u8)i;
+      sha512_init(&hash_ctx);
+      sha512_update(&hash_ctx, b_i, HASH_BYTES_SIZE);
+      sha512_update(&hash_ctx, block_info, 1);
+      sha512_update(&hash_ctx, ctx->dst_prime, ctx->dst_prime_len);
+      sha512_final(&hash_ctx, b_i);
+
+      chunk = out_len < HASH_BYTES_SIZE ? out_len : HASH_BYTES_SIZE;
+      COPY(j, out, b_i, chunk);
+      out += chunk;
+      out_len -= chunk;
+    }
+
+    WIPE_BUFFER(b_0); WIPE_BUFFER(b_i);
+    return 0;
+}
@@ -0,0 +1,67 @@
+// ******************************************************************
+// ----------------- TECHNICAL UNIVERSITY OF KOSICE -----------------
+// ---Department of Electronics and Multimedia Telecommunications ---
+// -------- FACULTY OF ELECTRICAL ENGINEERING AND INFORMATICS -------
+// ------------ THIS CODE IS A PART OF A MASTER'S THESIS ------------
+// ------------------------- Master thesis --------------------------
+// -----------------Patrik Zelenak & Milos Drutarovsky --------------
+// ---------------------------version 0.2.1 -------------------------
+// --------------------------- 19-10-2026 ---------------------------
+// ******************************************************************
+
+/**
+  * This file contains compact implementation of SHA-512
+  * (FIPS 180-4), which we use to turn arbitrary input (labels,
+  * messages) into 512-bit digest required by hash_to_group.
+  * Implementation follows FIPS 180-4 directly and it is written
+  * in the same spirit as SHA-512 in MonoCypher
+  * (https://github.com/LoupVaillant/Monocypher/blob/master/src/optional/monocypher-ed25519.c).
+  *
+  * Context can be copied at any point (e.g. after absorbing common
+  * prefix like domain label) and reused for more messages, so the
+  * prefix is hashed only once.
+  *
+  * File also contains expand_message_xmd from RFC 9380 (instantiated
+  * with SHA-512), which turns message and domain separation tag (DST)
+  * into uniform bytes, e.g. 64B input of hash_to_group. Everything
+  * that does not depend on message (SHA-512 state after zero block
+  * Z_pad and DST_prime) is precomputed once in xmd_ctx.
+**/
+
+#ifndef _SHA512_H
+#define _SHA512_H
+
+#include "helpers.h"
+
+#define SHA512_BLOCK_SIZE 128
+
+typedef struct sha512_ctx {
+    u64 hash[8];
+    u8 block[SHA512_BLOCK_SIZE];
+    // number of bytes in block
+    size_t block_len;
+    // total number of absorbed bytes
+    u64 total_len;
+} sha512_ctx;
+
+// maximal length of DST_prime (DST || I2OSP(len(DST), 1)), longer 
+// DST is replaced by its hash (RFC 9380, 5.3.3)
+#define XMD_MAX_DST_SIZE 255
+// maximal output of expand_message_xmd (ell <= 255)
+#define XMD_MAX_OUT_SIZE (255*HASH_BYTES_SIZE)
+
+typedef struct xmd_ctx {
+    // SHA-512 state after absorbing Z_pad (one zero block)
+    sha512_ctx zpad_state;
+    u8 dst_prime[XMD_MAX_DST_SIZE + 1];
+    size_t dst_prime_len;
+} xmd_ctx;
+
+void sha512_init(sha512_ctx* ctx);
+void sha512_update(sha512_ctx* ctx, const u8* message, size_t message_len);
+void sha512_final(sha512_ctx* ctx, u8 hash[HASH_BYTES_SIZE]);
+void sha512(u8 hash[HASH_BYTES_SIZE], const u8* message, size_t message_len);
+void xmd_init(xmd_ctx* ctx, const u8* dst, size_t dst_len);
+int expand_message_xmd(u8* out, size_t out_len, const u8* message, size_t message_len, const xmd_ctx* ctx);
+
+#endif //_SHA512_H
@@ -0,0 +1,311 @@
+// ******************************************************************
+// ----------------- TECHNICAL UNIVERSITY OF KOSICE -----------------
+// ---Department of Electronics and Multimedia Telecommunications ---
+// -------- FACULTY OF ELECTRICAL ENGINEERING AND INFORMATICS -------
+// ------------ THIS CODE IS A PART OF A MASTER'S THESIS ------------
+// ------------------------- Master thesis --------------------------
+// -----------------Patrik Zelenak & Milos Drutarovsky --------------
+// ---------------------------version 0.2.1 -------------------------
+// --------------------------- 19-10-2026 ---------------------------
+// ******************************************************************
+
+/**
+  * This file contains runtime measurement of peak stack usage of
+  * public API functions, build it and run it with `make stack_report`
+  * (the same target also prints static worst case computed from
+  * -fstack-usage/-fcallgraph-info, see stack_usage.py).
+  *
+  * Every function runs on its own stack (POSIX ucontext), which is
+  * painted by STACK_PAINT pattern before the call. After return we
+  * find the deepest byte that was overwritten, so the number is
+  * true peak of the function including everything it calls
+  * (minus constant overhead of context switch, which is measured
+  * by empty function and subtracted). The same painting can be used
+  * on MCU with stack of RTOS thread.
+  *
+  * With RISTRETTO255_STACK_BUDGET (see config.h) every function
+  * over budget is marked and program returns 1, so the report can
+  * be used as a check of low-stack profile (LOW_STACK_FLAG).
+  *
+  * Pool front-ends (ristretto255_pool_*) run on pool with workers
+  * (with THREAD_POOL_FLAG), but only stack of calling thread is
+  * painted. Workers run the same chunk functions on their own
+  * (pthread) stacks, their peak is the one of hash_to_group_ws,
+  * scalarmult_bits, decode and encode in this report.
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <ucontext.h>
+#include "ristretto255.h"
+#include "ristretto255_cache.h"
+#include "ristretto255_table_file.h"
+#include "ristretto255_pool.h"
+#include "modl.h"
+
+// size of painted stack of one measured function
+#define STACK_REPORT_SIZE (64*1024)
+#define STACK_PAINT 0xA5
+#define REPORT_BATCH 4
+// 2 chunks, so pool with workers really splits the batch
+#define REPORT_POOL_BATCH (2*RISTRETTO255_POOL_CHUNK)
+#define REPORT_TABLE_FILE "stack_report.tbl"
+
+static _Alignas(16) u8 test_stack[STACK_REPORT_SIZE];
+static ucontext_t main_ctx, test_ctx;
+static void (*current_test)(void);
+
+// inputs and outputs of measured functions (global, so they are
+// not placed on the measured stack)
+static const u8 basepoint[BYTES_ELEM_SIZE] = {
+    0xe2, 0xf2, 0xae, 0x0a, 0x6a, 0xbc, 0x4e, 0x71, 0xa8, 0x84, 0xa9, 0x61, 0xc5, 0x00, 0x51, 0x5f,
+    0x58, 0xe3, 0x0b, 0x6a, 0xa5, 0x82, 0xdd, 0x8d, 0xb6, 0xa6, 0x59, 0x45, 0xe0, 0x8d, 0x2d, 0x76
+};
+static u8 sc[BYTES_ELEM_SIZE];
+static u8 hash[HASH_BYTES_SIZE];
+static u8 bytes[BYTES_ELEM_SIZE];
+static u8 affine[AFFINE_BYTES_SIZE];
+static u8 many_bytes[REPORT_BATCH][BYTES_ELEM_SIZE];
+static u8 many_hashes[REPORT_BATCH][HASH_BYTES_SIZE];
+static u8 many_scalars[REPORT_BATCH][BYTES_ELEM_SIZE];
+static u8 many_affine[REPORT_BATCH][AFFINE_BYTES_SIZE];
+static const u8* msgs[REPORT_BATCH];
+static size_t msg_lens[REPORT_BATCH];
+static ristretto255_point P, Q, R;
+static ristretto255_point many_points[REPORT_BATCH], many_out[REPORT_BATCH];
+static ristretto255_niels_point many_niels[REPORT_BATCH];
+static ristretto255_table table;
+static ristretto255_table many_tables[REPORT_BATCH];
+static ristretto255_scalarmult_ctx sm_ctx;
+static ristretto255_handle handle, handle2, many_handles[REPORT_BATCH];
+static ristretto255_point_batch point_batch;
+static ristretto255_ws ws;
+static ristretto255_cache cache;
+static ristretto255_cache_entry cache_entries[2*RISTRETTO255_CACHE_WAYS];
+static ristretto255_cache_table cache_tables[1];
+static xmd_ctx xmd;
+static ristretto255_scalar s_a[REPORT_BATCH], s_b[REPORT_BATCH], s_r[REPORT_BATCH];
+static ristretto255_scalar_mont m_a, m_b;
+static ristretto255_mont_ws mont_ws;
+static _Alignas(64) u8 table_file_buf[RISTRETTO255_TABLE_FILE_HEADER_SIZE + sizeof(ristretto255_table)];
+static ristretto255_table_file table_file;
+static ristretto255_pool pool;
+static u8 pool_bytes[REPORT_POOL_BATCH][BYTES_ELEM_SIZE];
+static u8 pool_hashes[REPORT_POOL_BATCH][HASH_BYTES_SIZE];
+static u8 pool_scalars[REPORT_POOL_BATCH][BYTES_ELEM_SIZE];
+static ristretto255_point pool_points[REPORT_POOL_BATCH];
+static int pool_status[REPORT_POOL_BATCH];
+
+static void run_test(void){
+    current_test();
+}
+
+// returns peak stack usage of fn in bytes (including overhead
+// of run_test and context switch), fn is called once before
+// measurement, so lazy binding of libc symbols (dynamic linker)
+// is not counted
+static size_t measure(void (*fn)(void)){
+    size_t i;
+
+    fn();
+
+    memset(test_stack, STACK_PAINT, STACK_REPORT_SIZE);
+    getcontext(&test_ctx);
+    test_ctx.uc_stack.ss_sp = test_stack;
+    test_ctx.uc_stack.ss_size = STACK_REPORT_SIZE;
+    test_ctx.uc_link = &main_ctx;
+    makecontext(&test_ctx, run_test, 0);
+    current_test = fn;
+    swapcontext(&main_ctx, &test_ctx);
+
+    // stack grows down, first overwritten byte from the bottom
+    for (i = 0; i < STACK_REPORT_SIZE && test_stack[i] == STACK_PAINT; i++);
+    return STACK_REPORT_SIZE - i;
+}
+
+static void t_empty(void){ }
+static void t_decode(void){ ristretto255_decode(&P, basepoint); }
+static void t_encode(void){ ristretto255_encode(bytes, &P); }
+static void t_hash_to_group(void){ hash_to_group(bytes, hash); }
+static void t_hash_to_group_xmd(void){ ristretto255_hash_to_group_xmd(bytes, hash, 16, hash, 16); }
+static void t_hash_to_group_xmd_ctx(void){ ristretto255_hash_to_group_xmd_ctx(bytes, hash, 16, &xmd); }
+static void t_hash_to_group_xmd_batch(void){ ristretto255_hash_to_group_xmd_batch(many_bytes, msgs, msg_lens, REPORT_BATCH, &xmd); }
+static void t_scalarmult(void){ R = P; ristretto255_scalarmult(&Q, &R, sc); }
+static void t_point_addition(void){ ristretto255_point_addition(&Q, &P, &P); }
+static void t_point_addition_ws(void){ ristretto255_point_addition_ws(&Q, &P, &P, &ws); }
+static void t_point_addition_niels(void){ ristretto255_point_addition_niels(&Q, &P, &many_niels[0]); }
+static void t_batch_normalize(void){ ristretto255_batch_normalize(many_out, many_points, REPORT_BATCH); }
+static void t_batch_to_niels(void){ ristretto255_batch_to_niels(many_niels, many_points, REPORT_BATCH); }
+static void t_point_eq(void){ ristretto255_point_eq(&P, &Q); }
+static void t_export_affine(void){ ristretto255_export_affine(affine, &P); }
+static void t_export_affine_batch(void){ ristretto255_export_affine_batch(many_affine, many_points, REPORT_BATCH); }
+static void t_import_affine(void){ ristretto255_import_affine(&Q, affine); }
+static void t_table_build(void){ ristretto255_table_build(&table, &P); }
+static void t_scalarmult_table(void){ ristretto255_scalarmult_table(&Q, &table, sc); }
+static void t_scalarmult_ctx(void){
+    ristretto255_scalarmult_init(&sm_ctx, &P, sc);
+    while (ristretto255_scalarmult_step(&sm_ctx, 16) == 0);
+    ristretto255_scalarmult_finish(&sm_ctx, &Q);
+}
+static void t_scalarmult_many(void){ ristretto255_scalarmult_many(many_out, many_points, sc, REPORT_BATCH); }
+static void t_scalarmult_bits(void){ ristretto255_scalarmult_bits(&Q, &P, sc, 128); }
+static void t_scalarmult_batch_bits(void){ ristretto255_scalarmult_batch_bits(many_out, many_points, many_scalars, REPORT_BATCH, 128); }
+static void t_point_sum(void){ ristretto255_point_sum(&Q, many_points, REPORT_BATCH); }
+static void t_handle_decode(void){ ristretto255_handle_decode(&handle, basepoint); }
+static void t_handle(void){
+    ristretto255_handle_decode(&handle, basepoint);
+    ristretto255_handle_set_point(&handle2, &P);
+    ristretto255_handle_encode(bytes, &handle2);
+    ristretto255_handle_eq(&handle, &handle2);
+}
+static void t_handle_encode_batch(void){
+    int i;
+    FOR(i, 0, REPORT_BATCH) many_handles[i].has_encoding = 0;
+    ristretto255_handle_encode_batch(many_handles, REPORT_BATCH);
+}
+static void t_point_batch_load(void){ ristretto255_point_batch_load(&point_batch, many_points, REPORT_BATCH); }
+static void t_point_batch_store(void){ ristretto255_point_batch_store(many_out, &point_batch, REPORT_BATCH); }
+static void t_derive_generators(void){ ristretto255_derive_generators(many_out, hash, 16, 0, REPORT_BATCH); }
+static void t_derive_generator_tables(void){ ristretto255_derive_generator_tables(many_tables, hash, 16, 0, REPORT_BATCH); }
+static void t_decode_ws(void){ ristretto255_decode_ws(&Q, basepoint, &ws); }
+static void t_encode_ws(void){ ristretto255_encode_ws(bytes, &P, &ws); }
+static void t_hash_to_group_ws(void){ hash_to_group_ws(bytes, hash, &ws); }
+static void t_scalarmult_ws(void){ R = P; ristretto255_scalarmult_ws(&Q, &R, sc, &ws); }
+static void t_cache_decode(void){ ristretto255_cache_decode(&cache, &Q, basepoint); }
+static void t_cache_scalarmult(void){ ristretto255_cache_scalarmult(&cache, &Q, basepoint, sc); }
+static void t_table_file_parse(void){ ristretto255_table_file_parse(&table_file, table_file_buf, sizeof(table_file_buf)); }
+#ifdef TABLE_FILE_MMAP_FLAG
+static void t_table_file_map(void){
+    ristretto255_table_file_map(&table_file, REPORT_TABLE_FILE);
+    ristretto255_table_file_unmap(&table_file);
+}
+#endif
+static void t_pool_decode(void){ ristretto255_pool_decode(&pool, pool_points, (const u8 (*)[BYTES_ELEM_SIZE])pool_bytes, pool_status, REPORT_POOL_BATCH); }
+static void t_pool_encode(void){ ristretto255_pool_encode(&pool, pool_bytes, pool_points, pool_status, REPORT_POOL_BATCH); }
+static void t_pool_scalarmult(void){ ristretto255_pool_scalarmult(&pool, pool_points, pool_points, (const u8 (*)[BYTES_ELEM_SIZE])pool_scalars, pool_status, REPORT_POOL_BATCH); }
+static void t_pool_hash_to_group(void){ ristretto255_pool_hash_to_group(&pool, pool_bytes, (const u8 (*)[HASH_BYTES_SIZE])pool_hashes, pool_status, REPORT_POOL_BATCH); }
+static void t_sha512(void){ sha512(hash, hash, HASH_BYTES_SIZE); }
+static void t_xmd_init(void){ xmd_init(&xmd, hash, 16); }
+static void t_expand_message_xmd(void){ expand_message_xmd(hash, HASH_BYTES_SIZE, hash, 16, &xmd); }
+static void t_inverse_mod_l(void){ inverse_mod_l(bytes, sc); }
+static void t_crypto_x25519_inverse(void){ crypto_x25519_inverse(bytes, sc); }
+static void t_inverse_mod_l_chain(void){ inverse_mod_l_chain(bytes, sc); }
+static void t_modl_l_inverse_batch(void){ modl_l_inverse_batch(many_bytes, (const u8 (*)[BYTES_ELEM_SIZE])many_scalars, REPORT_BATCH); }
+static void t_scalar_mul(void){ ristretto255_scalar_mul(&s_r[0], &s_a[0], &s_b[0]); }
+static void t_scalar_invert(void){ ristretto255_scalar_invert(&s_r[0], &s_a[0]); }
+static void t_scalar_mont_mul(void){ ristretto255_scalar_mont_mul(&m_a, &m_a, &m_b); }
+static void t_scalar_mont_mul_ws(void){ ristretto255_scalar_mont_mul_ws(&m_a, &m_a, &m_b, &mont_ws); }
+static void t_scalar_from_wide_bytes(void){ ristretto255_scalar_from_wide_bytes(&s_r[0], hash); }
+static void t_scalar_from_wide_bytes_batch(void){ ristretto255_scalar_from_wide_bytes_batch(s_r, many_hashes, REPORT_BATCH); }
+static void t_scalar_mul_batch(void){ ristretto255_scalar_mul_batch(s_r, s_a, s_b, REPORT_BATCH); }
+static void t_scalar_inner_product(void){ ristretto255_scalar_inner_product(&s_r[0], s_a, s_b, REPORT_BATCH); }
+static void t_scalar_poly_eval(void){ ristretto255_scalar_poly_eval(&s_r[0], s_a, REPORT_BATCH, &s_b[0]); }
+static void t_scalar_lagrange_at_zero(void){ ristretto255_scalar_lagrange_at_zero(s_r, s_a, REPORT_BATCH); }
+
+typedef struct stack_test {
+    const char* name;
+    void (*fn)(void);
+} stack_test;
+
+#define STACK_TEST(name) { #name, t_##name }
+
+static const stack_test tests[] = {
+    STACK_TEST(decode), STACK_TEST(encode), STACK_TEST(hash_to_group),
+    STACK_TEST(hash_to_group_xmd),
+    STACK_TEST(hash_to_group_xmd_ctx), STACK_TEST(hash_to_group_xmd_batch),
+    STACK_TEST(scalarmult), STACK_TEST(point_addition), STACK_TEST(point_addition_ws),
+    STACK_TEST(point_addition_niels),
+    STACK_TEST(batch_normalize), STACK_TEST(batch_to_niels), STACK_TEST(point_eq),
+    STACK_TEST(export_affine), STACK_TEST(export_affine_batch), STACK_TEST(import_affine),
+    STACK_TEST(table_build), STACK_TEST(scalarmult_table), STACK_TEST(scalarmult_ctx),
+    STACK_TEST(scalarmult_many), STACK_TEST(scalarmult_bits),
+    STACK_TEST(scalarmult_batch_bits), STACK_TEST(point_sum), STACK_TEST(handle_decode),
+    STACK_TEST(handle), STACK_TEST(handle_encode_batch),
+    STACK_TEST(point_batch_load), STACK_TEST(point_batch_store),
+    STACK_TEST(derive_generators), STACK_TEST(derive_generator_tables),
+    STACK_TEST(decode_ws), STACK_TEST(encode_ws),
+    STACK_TEST(hash_to_group_ws), STACK_TEST(scalarmult_ws), STACK_TEST(cache_decode),
+    STACK_TEST(cache_scalarmult), STACK_TEST(table_file_parse),
+#ifdef TABLE_FILE_MMAP_FLAG
+    STACK_TEST(table_file_map),
+#endif
+    STACK_TEST(pool_decode), STACK_TEST(pool_encode), STACK_TEST(pool_scalarmult),
+    STACK_TEST(pool_hash_to_group), STACK_TEST(sha512), STACK_TEST(xmd_init),
+    STACK_TEST(expand_message_xmd), STACK_TEST(inverse_mod_l),
+    STACK_TEST(crypto_x25519_inverse), STACK_TEST(inverse_mod_l_chain),
+    STACK_TEST(modl_l_inverse_batch), STACK_TEST(scalar_mul), STACK_TEST(scalar_invert),
+    STACK_TEST(scalar_mont_mul), STACK_TEST(scalar_mont_mul_ws), STACK_TEST(scalar_from_wide_bytes),
+    STACK_TEST(scalar_from_wide_bytes_batch), STACK_TEST(scalar_mul_batch),
+    STACK_TEST(scalar_inner_product), STACK_TEST(scalar_poly_eval),
+    STACK_TEST(scalar_lagrange_at_zero),
+};
+
+int main(){
+    static const u8 cache_key[RISTRETTO255_CACHE_KEY_SIZE] = {1};
+    size_t overhead, peak;
+    int i, j, over = 0;
+    FILE* f;
+
+    // valid inputs for all measured functions
+    FOR(i, 0, BYTES_ELEM_SIZE) sc[i] = (u8)(0x35 * i + 1);
+    sc[31] &= 0x0f;
+    FOR(i, 0, HASH_BYTES_SIZE) hash[i] = (u8)(7 * i);
+    ristretto255_decode(&P, basepoint);
+    ristretto255_export_affine(affine, &P);
+    ristretto255_table_build(&table, &P);
+    ristretto255_table_file_header(table_file_buf, &table, 1, RISTRETTO255_TABLE_FILE_POINTS);
+    memcpy(table_file_buf + RISTRETTO255_TABLE_FILE_HEADER_SIZE, &table, sizeof(table));
+    f = fopen(REPORT_TABLE_FILE, "wb");
+    if (f != NULL){
+      fwrite(table_file_buf, 1, sizeof(table_file_buf), f);
+      fclose(f);
+    }
+    xmd_init(&xmd, hash, 16);
+    ristretto255_cache_init(&cache, cache_entries, 2*RISTRETTO255_CACHE_WAYS, cache_tables, 1, cache_key, 1);
+    FOR(i, 0, REPORT_BATCH){
+      FOR(j, 0, HASH_BYTES_SIZE) many_hashes[i][j] = (u8)(i + 3 * j);
+      hash_to_group(many_bytes[i], many_hashes[i]);
+      ristretto255_decode(&many_points[i], many_bytes[i]);
+      ristretto255_handle_set_point(&many_handles[i], &many_points[i]);
+      FOR(j, 0, BYTES_ELEM_SIZE) many_scalars[i][j] = (u8)(sc[j] + i);
+      ristretto255_scalar_decode(&s_a[i], many_scalars[i]);
+      ristretto255_scalar_from_wide_bytes(&s_b[i], many_hashes[i]);
+      msgs[i] = many_hashes[i];
+      msg_lens[i] = 16 + i;
+    }
+    ristretto255_batch_to_niels(many_niels, many_points, REPORT_BATCH);
+    ristretto255_point_batch_load(&point_batch, many_points, REPORT_BATCH);
+    ristretto255_scalar_to_mont(&m_a, &s_a[0]);
+    ristretto255_scalar_to_mont(&m_b, &s_b[0]);
+    FOR(i, 0, REPORT_POOL_BATCH){
+      memcpy(pool_bytes[i], many_bytes[i % REPORT_BATCH], BYTES_ELEM_SIZE);
+      memcpy(pool_hashes[i], many_hashes[i % REPORT_BATCH], HASH_BYTES_SIZE);
+      memcpy(pool_scalars[i], many_scalars[i % REPORT_BATCH], BYTES_ELEM_SIZE);
+    }
+    #ifdef THREAD_POOL_FLAG
+    ristretto255_pool_init(&pool, 2, NULL);
+    #else
+    ristretto255_pool_init(&pool, 0, NULL);
+    #endif
+
+    overhead = measure(t_empty);
+    printf("----- peak stack usage (runtime, painted stack) -----\n");
+    #ifdef RISTRETTO255_STACK_BUDGET
+    printf("budget: %d B\n", RISTRETTO255_STACK_BUDGET);
+    #endif
+    FOR(i, 0, (int)(sizeof(tests) / sizeof(tests[0]))){
+      peak = measure(tests[i].fn) - overhead;
+      printf("%-38s %6zu B", tests[i].name, peak);
+      #ifdef RISTRETTO255_STACK_BUDGET
+      if (peak > RISTRETTO255_STACK_BUDGET){
+        printf("  OVER BUDGET");
+        over = 1;
+      }
+      #endif
+      printf("\n");
+    }
+
+    ristretto255_pool_destroy(&pool);
+    remove(REPORT_TABLE_FILE);
+    return over;
+}
@@ -0,0 +1,101 @@
+# ******************************************************************
+# ----------------- TECHNICAL UNIVERSITY OF KOSICE -----------------
+# ---Department of Electronics and Multimedia Telecommunications ---
+# -------- FACULTY OF ELECTRICAL ENGINEERING AND INFORMATICS -------
+# ------------ THIS CODE IS A PART OF A MASTER'S THESIS ------------
+# ------------------------- Master thesis --------------------------
+# -----------------Patrik Zelenak & Milos Drutarovsky --------------
+# ---------------------------version 0.2.1 -------------------------
+# --------------------------- 19-10-2026 ---------------------------
+# ******************************************************************
+
+# Static worst-case stack usage of public functions, computed from
+# call graph files of GCC (-fstack-usage -fcallgraph-info=su, one
+# .ci file per translation unit), used by `make stack_report`.
+#
+# Worst case of function = own frame + max worst case of callees.
+# Functions with recursion, indirect calls (function pointers) or
+# dynamic frames (VLA, alloca) have no static bound, they are marked
+# in column "note" and their number is only lower bound. Calls of
+# external functions without .ci (libc: memset, printf, ...) are
+# counted as 0B and marked as well.
+#
+# usage: python3 stack_usage.py [--budget BYTES] file.ci [file.ci ...]
+# returns 1 if some public function is over budget
+
+import re
+import sys
+
+NODE_RE = re.compile(r'node: \{ title: "([^"]+)" label: "([^"]*)"')
+EDGE_RE = re.compile(r'edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+SIZE_RE = re.compile(r'(\d+) bytes \(([a-z,]+)\)')
+
+def parse(files):
+	# frames[title] = (bytes, qualifier), only for defined functions
+	frames = {}
+	calls = {}
+	for file_name in files:
+		with open(file_name) as f:
+			for line in f:
+				node = NODE_RE.search(line)
+				if node:
+					size = SIZE_RE.search(node.group(2))
+					if size:
+						frames[node.group(1)] = (int(size.group(1)), size.group(2))
+					calls.setdefault(node.group(1), set())
+					continue
+				edge = EDGE_RE.search(line)
+				if edge:
+					calls.setdefault(edge.group(1), set()).add(edge.group(2))
+	return frames, calls
+
+def worst_case(title, frames, calls, memo, path):
+	# returns (bytes, set of notes) of deepest call chain
+	if title in memo:
+		return memo[title]
+	if title in path:
+		return 0, {"recursion"}
+	if title == "__indirect_call":
+		return 0, {"indirect call"}
+	if title not in frames:
+		return 0, {"external " + title}
+	size, qualifier = frames[title]
+	notes = set()
+	if qualifier != "static":
+		notes.add(qualifier)
+	path.add(title)
+	deepest = 0
+	for callee in sorted(calls.get(title, ())):
+		callee_size, callee_notes = worst_case(callee, frames, calls, memo, path)
+		deepest = max(deepest, callee_size)
+		notes |= callee_notes
+	path.discard(title)
+	memo[title] = (size + deepest, notes)
+	return memo[title]
+
+def main(argv):
+	budget = None
+	if len(argv) > 1 and argv[0] == "--budget":
+		budget = int(argv[1])
+		argv = argv[2:]
+	frames, calls = parse(argv)
+	memo = {}
+	over = 0
+	print("----- worst-case stack usage (static, call graph) -----")
+	if budget is not None:
+		print("budget: %d B" % budget)
+	# static functions have title "file:name", public ones only "name"
+	public = [t for t in frames if ":" not in t]
+	rows = [(t,) + worst_case(t, frames, calls, memo, set()) for t in public]
+	for title, size, notes in sorted(rows, key=lambda r: (-r[1], r[0])):
+		line = "%-38s %6d B" % (title, size)
+		if budget is not None and size > budget:
+			line += "  OVER BUDGET"
+			over = 1
+		if notes:
+			line += "  (" + ", ".join(sorted(notes)) + ")"
+		print(line)
+	return over
+
+if __name__ == "__main__":
+	sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,120 @@
+// ******************************************************************
+// ----------------- TECHNICAL UNIVERSITY OF KOSICE -----------------
+// ---Department of Electronics and Multimedia Telecommunications ---
+// -------- FACULTY OF ELECTRICAL ENGINEERING AND INFORMATICS -------
+// ------------ THIS CODE IS A PART OF A MASTER'S THESIS ------------
+// ------------------------- Master thesis --------------------------
+// -----------------Patrik Zelenak & Milos Drutarovsky --------------
+// ---------------------------version 0.2.1 -------------------------
+// --------------------------- 19-10-2026 ---------------------------
+// ******************************************************************
+
+/**
+  * This file contains generator of precomputed table files (see
+  * ristretto255_table_file.h), build it with `make table_gen`.
+  *
+  *   ./table_gen out.tbl generators <label> <start> <count>
+  *       tables of generators ristretto255_derive_generators(label),
+  *       indexes start, ..., start+count-1 (e.g. Pedersen generators)
+  *   ./table_gen out.tbl points <hex> [<hex> ...]
+  *       tables of points given by their encodings in hex
+  *       (e.g. basepoint, hot public keys)
+  *
+  * File has to be generated on machine with the same byte order
+  * and layout of ristretto255_table as machines which load it.
+**/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ristretto255_table_file.h"
+
+static int parse_hex(u8 out[BYTES_ELEM_SIZE], const char* hex){
+    int i;
+    unsigned byte;
+
+    if (strlen(hex) != 2*BYTES_ELEM_SIZE){
+      return 1;
+    }
+    FOR(i, 0, BYTES_ELEM_SIZE){
+      if (sscanf(hex + 2*i, "%2x", &byte) != 1){
+        return 1;
+      }
+      out[i] = (u8)byte;
+    }
+    return 0;
+}
+
+static int usage(void){
+    printf("usage: table_gen <out> generators <label> <start> <count>\n");
+    printf("       table_gen <out> points <hex> [<hex> ...]\n");
+    return 1;
+}
+
+int main(int argc, char** argv){
+    u8 header[RISTRETTO255_TABLE_FILE_HEADER_SIZE];
+    ristretto255_table* tables;
+    ristretto255_point p;
+    u8 encoding[BYTES_ELEM_SIZE];
+    size_t count, i;
+    u32 tag;
+    FILE* f;
+
+    if (argc >= 6 && strcmp(argv[2], "generators") == 0){
+      count = (size_t)strtoull(argv[5], NULL, 10);
+      if (count == 0 || count > SIZE_MAX / sizeof(ristretto255_table)){
+        return usage();
+      }
+      tables = malloc(count * sizeof(ristretto255_table));
+      if (tables == NULL){
+        return 1;
+      }
+      ristretto255_derive_generator_tables(tables, (const u8*)argv[3], strlen(argv[3]), strtoull(argv[4], NULL, 10), count);
+      tag = RISTRETTO255_TABLE_FILE_GENERATORS;
+    }
+    else if (argc >= 4 && strcmp(argv[2], "points") == 0){
+      count = (size_t)(argc - 3);
+      tables = malloc(count * sizeof(ristretto255_table));
+      if (tables == NULL){
+        return 1;
+      }
+      FOR(i, 0, count){
+        if (parse_hex(encoding, argv[3 + i]) || ristretto255_decode(&p, encoding)){
+          printf("table_gen: invalid encoding %s\n", argv[3 + i]);
+          free(tables);
+          return 1;
+        }
+        ristretto255_table_build(&tables[i], &p);
+      }
+      tag = RISTRETTO255_TABLE_FILE_POINTS;
+    }
+    else{
+      return usage();
+    }
+
+    if (ristretto255_table_file_header(header, tables, count, tag)){
+      free(tables);
+      return 1;
+    }
+    f = fopen(argv[1], "wb");
+    if (f == NULL){
+      printf("table_gen: can not open %s\n", argv[1]);
+      free(tables);
+      return 1;
+    }
+    if (fwrite(header, 1, sizeof(header), f) != sizeof(header)
+        || fwrite(tables, sizeof(ristretto255_table), count, f) != count){
+      printf("table_gen: can not write %s\n", argv[1]);
+      fclose(f);
+      free(tables);
+      return 1;
+    }
+    if (fclose(f) != 0){
+      printf("table_gen: can not write %s\n", argv[1]);
+      free(tables);
+      return 1;
+    }
+    printf("table_gen: %zu tables (%zu B) written to %s\n", count, sizeof(header) + count * sizeof(ristretto255_table), argv[1]);
+    free(tables);
+    return 0;
+}